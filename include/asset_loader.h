@@ -0,0 +1,84 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "asset_pack.h"
+#include "mesh_data.h"
+#include "mesh_optimizer.h"
+#include "texture_manager.h"
+
+// Todo lo que necesita ModelRenderer, ya en CPU y sin tocar OpenGL
+struct ModelAsset {
+    std::string path;
+    MeshData mesh;                      // optimizada, en float (colisiones)
+    std::vector<GpuMesh> gpuLods;       // cuantizadas, lo que se sube; [0] la completa
+    MeshOptStats meshStats;
+    bool meshOptimized = false;         // false si ya venia optimizada del paquete
+    std::vector<DecodedImage> images;   // una por ruta de textura distinta
+    bool imagesPending = false;         // las imagenes llegan despues (AssetLoader::TakeImages)
+    bool ok = false;
+    double loadMs = 0;                  // desde que se pidio hasta que quedo listo
+};
+
+ModelAsset LoadModelAsset(const std::string& path, const AssetPack* pack = nullptr);
+// Carga en serie en el hilo actual
+
+// Pool de hilos que importa mallas y decodifica imagenes en paralelo. El hilo
+// de OpenGL recoge la malla apenas esta (TakeMesh) y la sube con
+// ModelRenderer(ModelAsset&&); las imagenes las va recogiendo frame a frame
+// con TakeImages a medida que se decodifican (ModelRenderer::AddTextures).
+class AssetLoader {
+public:
+    explicit AssetLoader(int workers = 0);   // 0: un hilo por nucleo, menos el de OpenGL
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    int Load(const std::string& path, const AssetPack* pack = nullptr);
+    // Encola la malla; al terminarla se encola una decodificacion por textura.
+    // Las imagenes del paquete son vistas al mapeo: debe seguir abierto hasta
+    // que el TextureManager que las recibe deje de subir (Streaming() false)
+
+    ModelAsset TakeMesh(int id);
+    // Espera solo la malla y la entrega (una sola vez), con imagesPending
+
+    bool TakeImages(int id, std::vector<DecodedImage>& out);
+    // Sin esperar: agrega a out las imagenes decodificadas desde la llamada
+    // anterior. true cuando ya se entregaron todas
+
+    int Workers() const { return (int)threads.size(); }
+
+private:
+    struct Job {
+        ModelAsset asset;
+        const AssetPack* pack;
+        bool meshDone = false;
+        bool meshTaken = false;
+        std::vector<DecodedImage> images;   // fuera de asset: se decodifican despues de TakeMesh
+        std::vector<char> imageState;       // 0 decodificando, 1 lista, 2 entregada
+        int pending = 0;                    // imagenes sin entregar
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void Push(std::function<void()> task);
+    void Run();
+    void LoadMesh(Job* job);
+    void DecodeImage(Job* job, size_t i);
+
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::mutex mutex;
+    std::condition_variable taskReady, meshDone;
+    bool stopping = false;
+};
+
+#endif
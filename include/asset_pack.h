@@ -0,0 +1,121 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mesh_data.h"
+
+// Paquete binario de recursos horneados (ver tools/asset_baker.cpp):
+//   encabezado | datos de cada entrada (alineados a 16) | indice
+// Mallas ya normalizadas y optimizadas con sus niveles de detalle (entradas
+// "<modelo>#lod1", "#lod2"... con el mismo formato), y texturas RGBA8 con toda
+// la cadena de mipmaps.
+// Todo en el orden de bytes de la maquina que lo horneo (little endian).
+namespace AssetPackFormat {
+    const char MAGIC[4] = { 'P', 'A', 'C', 'K' };
+    const uint32_t VERSION = 4;   // 2: mallas optimizadas (mesh_optimizer), 3: rangos partidos, 4: LODs
+    const uint32_t TYPE_MESH = 1;
+    const uint32_t TYPE_TEXTURE = 2;
+    const uint32_t TYPE_MESH_LOD = 3;
+    const size_t NAME_SIZE = 256;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t indexOffset;
+    };
+    struct IndexEntry {
+        char name[NAME_SIZE];   // ruta con la que se pide el recurso
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+    struct MeshHeader {
+        uint32_t vertexCount;   // vertices de MeshData::VERTEX_STRIDE floats
+        uint32_t indexCount;
+        uint32_t materialCount;
+        uint32_t rangeCount;
+    };
+    struct MaterialRecord {
+        char texturePath[NAME_SIZE];
+        float diffuse[3];
+        uint32_t reserved;
+    };
+    struct TextureHeader {
+        uint32_t width, height;
+        uint32_t levels;   // nivel 0 .. 1x1
+        uint32_t reserved;
+        uint64_t hash;     // del nivel 0, para deduplicar por contenido sin releer
+    };
+}
+
+// Vista de una textura dentro del paquete mapeado (sin copia)
+struct PackedTexture {
+    int width = 0, height = 0, levels = 0;
+    uint64_t hash = 0;
+    const unsigned char* data = nullptr;   // niveles RGBA8 consecutivos
+
+    static size_t LevelBytes(int width, int height, int level);
+    const unsigned char* Level(int level) const;
+};
+
+// Paquete mapeado en memoria (mmap en POSIX, MapViewOfFile en Windows)
+class AssetPack {
+public:
+    AssetPack() = default;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+    ~AssetPack() { Close(); }
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return base != nullptr; }
+    static bool IsOutdated(const std::string& path);
+    // Existe y es un paquete, pero de otra version (hay que volver a hornearlo)
+
+    bool LoadMesh(const std::string& name, MeshData& mesh) const;
+    // Copia la malla (se necesita en CPU para colisiones)
+    bool LoadLods(const std::string& name, std::vector<MeshData>& lods) const;
+    // Niveles simplificados horneados (sin la malla completa), como BuildLods
+    bool FindTexture(const std::string& name, PackedTexture& tex) const;
+
+private:
+    struct Entry {
+        uint32_t type;
+        uint64_t offset, size;
+    };
+    const Entry* Find(const std::string& name, uint32_t type) const;
+    bool ReadMesh(const Entry& e, MeshData& mesh) const;
+
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    std::unordered_map<std::string, Entry> index;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+uint64_t HashImage(int width, int height, const unsigned char* rgba, size_t size);
+// FNV-1a sobre dimensiones y pixeles (deduplicacion por contenido)
+
+int MipLevelCount(int width, int height);
+// Niveles de la cadena completa, del nivel 0 al 1x1
+
+// Horneado (herramienta offline)
+void BuildMipChain(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out);
+// Todos los niveles con filtro de caja 2x2, consecutivos desde el nivel 0
+
+bool WriteAssetPack(const std::string& path, const std::vector<std::string>& models);
+// Carga cada modelo con LoadMeshData, lo optimiza y genera sus LODs, carga sus
+// texturas con stb y escribe el paquete
+
+#endif
@@ -4,8 +4,16 @@
 #include <opencv2/opencv.hpp>
 #include <glm/glm.hpp>
 #include <chrono>
+#include <cstdint>
 #include <string>
+#include <thread>
+#include <vector>
 #include "model_renderer.h"
+#include "track_bvh.h"
+#include "racing_line.h"
+#include "opponents.h"
+#include "lap_timer.h"
+#include "ghost.h"
 #include "marker_detection.h"
 #include "vision/gesture_recognition.h"
 
@@ -13,21 +21,98 @@
 class GameController {
 public:
     GameController(ModelRenderer& renderer, VisionProcessor& vision,
-                   const cv::Mat& K, const cv::Mat& dist);
+                   const cv::Mat& K, const cv::Mat& dist, int numJugadores = 1);
+    ~GameController();
 
     void process(cv::Mat& frameMarker, cv::Mat& frameHand);
+    void process(cv::Mat& frame);   // una sola camara para marcador y mano
     void drawModel(const glm::mat4& projection);
     std::string getStatusText() const;
     glm::vec3 getPosition() const;
     void resetPosition();
+    void setTickRate(double hz);     // frecuencia de la simulacion (ticks por segundo)
+    double getSimTime() const;       // reloj de simulacion en segundos
+    void setPista(const ModelRenderer& pistaRenderer, const std::string& cachePath = "");
+    // Construye el BVH de la pista para colisiones y seguimiento del suelo,
+    // y la linea de carrera de los rivales (horneada o leida de cachePath)
+    void setOponentes(int n);        // rivales controlados por la computadora
+    void setCheckpoints(const std::string& path);
+    // Lee las compuertas (espacio del marcador); si no hay archivo las genera
+    // desde la linea de carrera y lo escribe para poder editarlas
+    void setFantasma(const std::string& path);
+    // Carga la mejor vuelta guardada; las nuevas mejores vueltas se guardan ahi
     void drawStaticPista(const glm::mat4& projection, ModelRenderer& pistaRenderer);
     static bool inicializarCalibracion(cv::Mat& K, cv::Mat& dist, int cameraIndex = 0);
+
+    // Modelo del vehiculo, en unidades del espacio del carro
+    struct ParametrosVehiculo {
+        float aceleracion = 2.0f;        // u/s^2 con Advance
+        float frenado = 4.0f;            // u/s^2 con Stop mientras avanza
+        float arrastre = 0.8f;           // u/s^2 sin gesto
+        float velocidadMax = 2.0f;
+        float velocidadReversa = 0.8f;
+        float factorFueraPista = 0.4f;   // velocidad maxima fuera de la pista
+        float giroMax = 2.5f;            // rad/s con el volante al tope
+        float tasaVolante = 4.0f;        // cambio del volante por segundo
+        float radio = 0.3f;              // radio de colision contra paredes
+        float alturaRayo = 0.5f;         // busqueda del suelo por encima y debajo
+    } vehiculo;
+
 private:
+    void procesarMarcador(cv::Mat& frame, const cv::Mat& gray);
+    void procesarMano(const cv::Mat& frame, const cv::Mat& gray);
+    void actualizarJuego();
+
+    // Estado de la simulacion de un carro en un tick
+    struct EstadoCarro {
+        glm::vec3 position = glm::vec3(0.0f);
+        float heading = 0.0f;    // radianes, 0 = hacia +z
+        float speed = 0.0f;      // unidades por segundo, negativo en reversa
+        float steer = 0.0f;      // volante [-1,1], cambia con tasa limitada
+        bool enPista = true;
+    };
+    EstadoCarro estadoInicial(size_t jugador) const;
+    void tick(EstadoCarro& estado, Gesture gesto, bool activo, float dt);
+
     ModelRenderer& renderer;
     VisionProcessor& vision;
 
-    glm::vec3 position;
-    std::string accion;
+    // Un carro por jugador, cada uno controlado por su mano
+    struct Jugador {
+        EstadoCarro estado, estadoPrevio;   // ultimos dos ticks, se interpola al dibujar
+        std::string accion = "Sin gesto";
+        Gesture gesto = Gesture::None;   // ultimo gesto estable recibido del tracker
+        double gestoConfianza = 0.0;
+    };
+    std::vector<Jugador> jugadores;
+
+    // Paso fijo: la simulacion avanza en ticks de 1/tickRate segundos
+    double tickRate;
+    double acumulador;               // tiempo real pendiente de simular
+    double alpha;                    // fraccion del tick actual, para interpolar
+    uint64_t ticks;
+    std::chrono::steady_clock::time_point lastUpdateTime;
+
+    TrackBVH pistaBvh;   // en el espacio del carro
+
+    RacingLine lineaCarrera;
+    Opponents oponentes;
+    int numOponentes = 0;
+    double oponentesMs = 0.0;   // costo promedio de un tick de los rivales
+
+    LapTimer cronometro;        // corredores: jugadores y despues los rivales
+    void reiniciarCronometro();
+
+    // Fantasmas del jugador 1: se graba cada vuelta y se reproducen la mejor y la ultima
+    GhostRecorder grabador;
+    GhostPlayer fantasmaMejor, fantasmaUltima;
+    std::string fantasmaPath;
+    void grabarFantasma(bool vueltaIniciada, bool vueltaCompleta, double t1);
+    // La nueva mejor vuelta se marca en el tick y se escribe despues del bucle
+    // de simulacion en un hilo aparte, para que el disco no consuma ticks
+    bool fantasmaPendiente = false;
+    std::thread guardadoFantasma;
+    void guardarFantasma();
 
     PoseData pose, lastPose;
     bool hasLastPose;
@@ -0,0 +1,66 @@
+#ifndef GHOST_H
+#define GHOST_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Trayectoria de una vuelta: un cuadro por tick con posicion y rumbo cuantizados.
+// Cada cuadro se guarda como diferencia con el anterior (varint zigzag),
+// con un cuadro clave absoluto cada KEY_INTERVAL para poder buscar.
+struct GhostTrack {
+    static constexpr uint32_t KEY_INTERVAL = 64;
+    static constexpr uint32_t VERSION = 1;
+
+    float tickRate = 60.0f;
+    float posStep = 1.0f / 1024.0f;   // resolucion de la posicion
+    float startOffset = 0.0f;         // tiempo de vuelta del primer cuadro
+    double lapTime = -1.0;
+    uint32_t frameCount = 0;
+    std::vector<uint32_t> keyOffsets;   // byte de inicio de cada cuadro clave
+    std::vector<uint8_t> data;
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+    size_t Bytes() const { return data.size() + keyOffsets.size() * sizeof(uint32_t); }
+};
+
+class GhostRecorder {
+public:
+    void Start(float tickRate, float startOffset);
+    void Add(const glm::vec3& position, float heading);
+    void Stop() { recording = false; }
+
+    bool Recording() const { return recording; }
+    GhostTrack& Track() { return track; }
+
+private:
+    GhostTrack track;
+    int32_t prev[4] = { 0, 0, 0, 0 };
+    bool recording = false;
+};
+
+// Reproduce una trayectoria decodificando en orden; solo busca un cuadro clave
+// si el tiempo pedido salta hacia atras o muy adelante
+class GhostPlayer {
+public:
+    void SetTrack(const GhostTrack& t);
+    bool Sample(double lapTime, glm::vec3& position, float& heading);
+    // false antes del primer cuadro o despues del ultimo
+
+    bool Empty() const { return track.frameCount < 2; }
+    const GhostTrack& Track() const { return track; }
+
+private:
+    void Seek(uint32_t frame);
+    void Next();
+
+    GhostTrack track;
+    size_t cursor = 0;
+    uint32_t frame = 0;
+    bool valid = false;
+    int32_t cur[4] = { 0, 0, 0, 0 }, prev[4] = { 0, 0, 0, 0 };
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef LAP_TIMER_H
+#define LAP_TIMER_H
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "racing_line.h"
+
+// Compuerta de control: segmento a-b en el plano xz del espacio del carro.
+// Cuenta solo si se cruza hacia adelante: cross(avance, b - a) > 0
+struct CheckpointGate {
+    glm::vec2 a, b;
+    bool sector = false;   // fin de sector (la compuerta 0 siempre es salida/meta)
+};
+
+// Cronometro de vueltas y sectores a partir de cruces de compuertas.
+// Las compuertas se buscan en un hash espacial uniforme; los tiempos
+// vienen del reloj de simulacion e incluyen la fraccion del tick del cruce.
+// Cruzar una compuerta hacia atras marca contramano; cruzar una mas adelante
+// que la siguiente salta las intermedias y la vuelta queda invalida.
+class LapTimer {
+public:
+    struct Racer {
+        int nextGate = 0;
+        int lap = 0;                    // 0 = aun no cruza la salida
+        double lapStart = 0.0, sectorStart = 0.0;
+        double lastLap = -1.0, bestLap = -1.0;
+        bool wrongWay = false;          // ultimo cruce hacia atras
+        int skipped = 0;                // compuertas saltadas en la vuelta en curso
+        bool lastLapValid = true;       // la mejor vuelta solo cuenta vueltas validas
+        std::vector<double> sectors;       // vuelta en curso
+        std::vector<double> lastSectors;   // ultima vuelta completa
+    };
+
+    bool Load(const std::string& path, const glm::mat4& simFromMarker);
+    bool Save(const std::string& path, const glm::mat4& markerFromSim) const;
+    // En disco las compuertas estan en el plano del marcador (x, y)
+
+    void GenerateFromLine(const RacingLine& line, int count, int sectorEvery);
+    // Compuertas perpendiculares a la linea de carrera, de borde a borde
+
+    void SetGates(const std::vector<CheckpointGate>& gates);
+    void ResetRacers(size_t count);
+
+    bool Update(size_t racer, const glm::vec2& from, const glm::vec2& to, double t0, double t1);
+    // Movimiento de un tick [t0, t1]; devuelve true si se completo una vuelta
+
+    const std::vector<CheckpointGate>& Gates() const { return gates; }
+    const Racer& GetRacer(size_t i) const { return racers[i]; }
+    size_t RacerCount() const { return racers.size(); }
+
+private:
+    void BuildHash();
+    int Bucket(int cx, int cz) const;
+    bool Cross(Racer& r, double tc);
+    // Pasa la compuerta r.nextGate en el instante tc; true si cierra vuelta
+
+    std::vector<CheckpointGate> gates;
+    std::vector<Racer> racers;
+
+    // hash espacial: celdas de tamanio cellSize, listas compactas por cubeta
+    float cellSize = 1.0f;
+    int tableMask = 0;
+    std::vector<int> bucketStart;   // tableMask + 2 entradas
+    std::vector<int> bucketItems;
+
+    struct Crossing {
+        float t;        // fraccion del tick
+        int gate;
+        bool forward;
+    };
+    std::vector<Crossing> crossings;   // por Update, reutilizado
+};
+
+#endif
@@ -8,6 +8,7 @@
 struct PoseData {
     cv::Mat rvec;
     cv::Mat tvec;
+    std::vector<cv::Point2f> esquinas;  // esquinas del marcador en la imagen
     bool poseValida = false;
 };
 
@@ -32,6 +33,8 @@ void cameraMatrixToGLProjection(const cv::Mat& cameraMatrix, float width, float
 bool obtenerPoseDelMarcador(const std::vector<cv::Point2f>& imagenPts, const cv::Mat& cameraMatrix,
                            const cv::Mat& distCoeffs, cv::Mat& rvec, cv::Mat& tvec);
 void procesarFrame(cv::Mat& frame, const cv::Mat& cameraMatrix, const cv::Mat& distCoeffs, PoseData& poseData);
+void procesarFrame(cv::Mat& frame, const cv::Mat& gray, const cv::Mat& cameraMatrix, const cv::Mat& distCoeffs,
+                   PoseData& poseData);  // gris ya calculado (modo de una camara)
 
 bool captureCalibrationImages(int num_images = 20, const std::string& filename_prefix = "calibrate/calib_", 
                              int g_cameraIndex = 0);
@@ -0,0 +1,42 @@
+#ifndef MESH_DATA_H
+#define MESH_DATA_H
+
+#include <string>
+#include <vector>
+
+struct MeshMaterial {
+    std::string texturePath;                 // textura difusa, vacia si no hay
+    float diffuse[3] = { 1.0f, 1.0f, 1.0f };   // color difuso (Kd), si no hay textura
+};
+
+// Rango de indices que se dibuja con un material
+struct DrawRange {
+    unsigned int material;
+    unsigned int indexOffset;
+    unsigned int indexCount;
+};
+
+// Geometria de un modelo en memoria, sin depender de OpenGL
+// Vertices intercalados: posicion (3) + uv (2). Todas las mallas comparten
+// un solo arreglo de vertices e indices, ordenado por material.
+struct MeshData {
+    static const int VERTEX_STRIDE = 5;
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshMaterial> materials;
+    std::vector<DrawRange> ranges;   // un rango por material usado
+
+    size_t VertexCount() const { return vertices.size() / VERTEX_STRIDE; }
+    size_t TriangleCount() const { return indices.size() / 3; }
+};
+
+// Carga todas las mallas con Assimp, las une y las normaliza a [-1,1]
+bool LoadMeshData(const std::string& path, MeshData& mesh);
+
+void NormalizeModel(std::vector<float>& verts);
+
+std::string ResolveTexturePath(const std::string& dir, const std::string& ref);
+// Ruta normalizada; rutas que no existen se buscan por nombre en dir
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include <vector>
+#include "mesh_data.h"
+
+// Niveles de detalle por agrupamiento de vertices en una grilla: los vertices
+// de una misma celda se funden en una posicion comun (promedio de la celda en
+// toda la malla, sin grietas entre rangos) con la uv promediada por rango, y
+// se descartan los triangulos que quedan degenerados o repetidos.
+namespace MeshLod {
+    const int MAX_LODS = 4;          // la malla completa + hasta 3 simplificadas
+    const int FIRST_GRID = 64;       // celdas en el eje mas largo del primer nivel
+    const float MIN_REDUCTION = 0.75f;   // un nivel que no baja de esto no se agrega
+}
+
+void SimplifyMesh(const MeshData& mesh, int gridCells, MeshData& out);
+
+void BuildLods(const MeshData& mesh, std::vector<MeshData>& lods);
+// Niveles simplificados (sin la malla completa), grilla a la mitad en cada uno
+// y optimizados para la cache como la original
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "mesh_data.h"
+
+// Optimizacion de la malla antes de subirla:
+//   1. soldar vertices identicos (posicion + uv)
+//   2. partir los rangos grandes por celdas del espacio (para descartar los
+//      que quedan fuera de la vista)
+//   3. reordenar triangulos para la cache post-transformacion (Forsyth)
+//   4. reordenar vertices por primer uso (localidad al leerlos)
+// Los rangos quedan ordenados por material; cada uno se reordena por separado.
+struct MeshOptStats {
+    size_t verticesBefore = 0, verticesAfter = 0;
+    double acmrBefore = 0, acmrAfter = 0;   // vertices transformados por triangulo
+    size_t bytesBefore = 0, bytesAfter = 0; // formato float de 20 bytes frente a GpuMesh
+};
+
+MeshOptStats OptimizeMesh(MeshData& mesh);
+// bytesAfter queda en 0: lo llena quien construye el GpuMesh
+
+const int SPLIT_CELLS = 4;               // celdas en el eje mas largo
+const int SPLIT_MIN_TRIANGLES = 512;     // rangos mas chicos no se parten
+
+void WeldVertices(MeshData& mesh);
+void SplitRanges(MeshData& mesh, int cells = SPLIT_CELLS);
+void OptimizeVertexCache(MeshData& mesh);
+void OptimizeVertexFetch(MeshData& mesh);
+
+double ComputeACMR(const MeshData& mesh, int cacheSize = 16);
+// Con una cache FIFO de cacheSize vertices (0.5 ideal, 3 sin reutilizacion)
+
+// Vertice compacto: posicion SNORM16 + uv UNORM16, 12 bytes
+struct PackedVertex {
+    int16_t position[3];
+    int16_t pad;
+    uint16_t uv[2];
+};
+
+// Rango listo para glDrawElementsBaseVertex
+struct GpuDrawRange {
+    unsigned int material;
+    unsigned int indexCount;
+    size_t byteOffset;        // en indexData
+    int baseVertex;
+    bool shortIndices;        // 16 bits si los vertices del rango caben
+    unsigned int vertexSpan;  // vertices entre el menor y el mayor indice del rango
+    float boundsMin[3], boundsMax[3];   // caja en espacio del modelo (sin cuantizar)
+};
+
+// Malla cuantizada para la GPU. posicion = posOffset + q * posScale y
+// uv = uvOffset + q * uvScale, con q normalizado a [-1,1] y [0,1].
+struct GpuMesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<unsigned char> indexData;   // indices de 16 o 32 bits por rango
+    std::vector<GpuDrawRange> ranges;
+    size_t vertexCount = 0;
+    float posOffset[3] = { 0, 0, 0 }, posScale[3] = { 1, 1, 1 };
+    float uvOffset[2] = { 0, 0 }, uvScale[2] = { 1, 1 };
+
+    size_t Bytes() const { return vertices.size() * sizeof(PackedVertex) + indexData.size(); }
+};
+
+void BuildGpuMesh(const MeshData& mesh, GpuMesh& out);
+
+size_t FloatMeshBytes(const MeshData& mesh);
+// Vertices de 5 floats e indices de 32 bits
+
+#endif
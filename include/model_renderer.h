@@ -2,36 +2,99 @@
 #define MODEL_RENDERER_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <opencv2/opencv.hpp>
+#include "mesh_data.h"
+#include "mesh_lod.h"
+#include "asset_loader.h"
+#include "texture_manager.h"
+
+// Contadores de dibujo (por frame) y de carga (bytes subidos a la GPU)
+struct RenderStats {
+    unsigned int drawCalls = 0;
+    size_t triangles = 0;
+    size_t vertices = 0;         // de los rangos visibles del nivel dibujado
+    unsigned int visible = 0;    // rangos dentro de la vista
+    unsigned int culled = 0;     // rangos descartados por estar fuera
+    unsigned int lodDraws[MeshLod::MAX_LODS] = {};
+    size_t uploadBytes = 0;
+    unsigned int textures = 0;
+    size_t streamBytes = 0;      // texturas subidas este frame
+    size_t streamPending = 0;    // por subir
+    double streamMs = 0;
+    unsigned int stalls = 0;     // frames de subida por encima de TextureManager::STALL_MS
+};
 
 extern const char* vertexShaderSource_model;
 extern const char* fragmentShaderSource_model;
 
 class ModelRenderer {
 public:
-    ModelRenderer(const std::string& path);
+    ModelRenderer(const std::string& path, const AssetPack* pack = nullptr);
+    // Con paquete abierto se evita Assimp y la decodificacion de imagenes
+    explicit ModelRenderer(ModelAsset&& asset);
+    // Solo la subida a la GPU; la carga ya se hizo en otro hilo (AssetLoader).
+    // Con asset.imagesPending se dibuja con el color difuso hasta AddTextures
+    void AddTextures(std::vector<DecodedImage>&& images, bool last);
+    // Imagenes que terminaron de decodificarse; con la ultima se crean los
+    // arreglos y empieza la subida progresiva
     void SetModelMatrix(const glm::mat4& model);
     void SetViewProjection(const glm::mat4& view, const glm::mat4& projection);
-    void Draw();
+    void SetAlpha(float a);   // < 1 dibuja translucido (carro fantasma)
+    void BeginFrame();        // reinicia los contadores por frame y sube texturas pendientes
+    // Nivel de detalle por tamanio en pantalla (la vista sale del tvec del
+    // marcador); cada instancia (clave de Draw) guarda su propio nivel
+    static constexpr float LOD_SCREEN_SIZE = 0.4f;   // diametro / alto de pantalla del nivel 0
+    static constexpr float LOD_HYSTERESIS = 0.2f;    // margen para cambiar de nivel
+    void SetStreamBudget(size_t bytes) { streamBudget = bytes; }   // por frame
+    const RenderStats& GetStats() const { return stats; }
+    void Draw(int instance = 0);
+    // instance: clave estable del objeto dibujado (p. ej. carro de un jugador),
+    // no el orden de la llamada en el frame
+
+    const MeshData& GetMesh() const { return mesh; }   // geometria en CPU (colisiones)
 
 private:
-    void LoadModel(const std::string& path);
+    void UploadAsset(ModelAsset&& asset);
     void SetupMesh();
-    GLuint LoadTexture(const std::string& filename);
+    float ScreenSize() const;
+    static void FrustumPlanes(const glm::mat4& viewProjModel, glm::vec4 planes[6]);
+    static bool BoxOutside(const glm::vec4 planes[6], const float* lo, const float* hi);
+    int SelectLod(float screenSize, int current) const;
+
+    MeshData mesh;
+    // Un nivel de detalle en la GPU; de la malla solo quedan rangos y decuantizacion
+    struct GpuLod {
+        GLuint VAO, VBO, EBO;
+        GpuMesh mesh;
+        glm::mat4 dequant;
+    };
+    std::vector<GpuLod> lods;       // [0] la completa
+    glm::vec3 boundsCenter;         // esfera envolvente en espacio del modelo
+    float boundsRadius = 0.0f;
+    std::unordered_map<int, int> lodStates;   // nivel actual por instancia
+
+    // por Draw, reutilizados entre frames
+    std::vector<const GpuDrawRange*> visibleRanges;
+    std::vector<GLsizei> drawCounts;
+    std::vector<const void*> drawOffsets;
+    std::vector<GLint> drawBases;
 
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    
-    GLuint VAO, VBO, EBO;
     GLuint shaderProgram;
-    GLuint textureID = 0;
+    TextureManager textures;
+    std::vector<TextureRef> materialTextures;   // array -1 si el material no tiene textura
+    std::vector<TextureRef> pendingTextures;    // asignadas, sin arreglos en la GPU hasta la ultima imagen
+    bool texturesReady = false;
+    RenderStats stats;
 
     glm::mat4 modelMatrix;
     glm::mat4 viewMatrix;
     glm::mat4 projectionMatrix;
+    float alpha = 1.0f;
+    size_t streamBudget = 2 * 1024 * 1024;
 
 };
 
@@ -0,0 +1,39 @@
+#ifndef OPPONENTS_H
+#define OPPONENTS_H
+
+#include <vector>
+#include "racing_line.h"
+
+// Carros controlados por la computadora.
+// Estado en estructura de arreglos: cada campo es un arreglo contiguo por carro.
+class Opponents {
+public:
+    struct Params {
+        float lookahead = 0.8f;      // distancia del punto objetivo sobre la linea
+        float aceleracion = 1.5f;
+        float velocidadMax = 1.8f;   // se varia por carro
+        float giroMax = 2.5f;        // rad/s
+        float gananciaGiro = 4.0f;
+        float margen = 0.15f;        // distancia al borde a partir de la cual se esquiva
+        float gananciaBorde = 2.0f;
+    } params;
+
+    void Reset(const RacingLine& line, int count);
+    // Parrilla de salida detras del inicio de la linea
+
+    void Update(const RacingLine& line, float dt);
+    // Un tick de simulacion; guarda el estado anterior para interpolar
+
+    size_t Size() const { return x.size(); }
+
+    std::vector<float> x, y, z, heading, speed;
+    std::vector<float> prevX, prevY, prevZ, prevHeading;
+    std::vector<float> topSpeed;   // velocidad maxima propia de cada carro
+    std::vector<int> segment;      // muestra de la linea mas cercana
+
+private:
+    // valores intermedios de cada tick, para separar consultas e integracion
+    std::vector<float> yawRate, targetSpeed;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef RACING_LINE_H
+#define RACING_LINE_H
+
+#include <opencv2/opencv.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mesh_data.h"
+
+// Linea de carrera y campo de distancia 2D (plano xz) de la zona transitable.
+// Se hornea a partir de la malla de la pista y se guarda en cache.
+class RacingLine {
+public:
+    static constexpr int CACHE_VERSION = 1;
+
+    bool LoadOrBake(const std::string& cachePath, const MeshData& mesh, const glm::mat4& transform);
+    // Usa la cache si corresponde a la misma malla; si no, hornea y la reescribe
+
+    bool Bake(const MeshData& mesh, const glm::mat4& transform, int resolution = 256);
+    bool SaveCache(const std::string& path, uint64_t meshHash) const;
+    bool LoadCache(const std::string& path, uint64_t meshHash);
+    static uint64_t HashMesh(const MeshData& mesh, const glm::mat4& transform);
+
+    float Distance(float x, float z) const;
+    // Distancia al borde de la pista, positiva dentro (interpolacion bilineal)
+    glm::vec2 Gradient(float x, float z) const;
+    // Direccion hacia el interior de la pista (sin normalizar)
+    float Height(float x, float z) const;
+
+    int Nearest(const glm::vec2& p, int hint, int window) const;
+    // Muestra mas cercana buscando alrededor de hint (la linea es cerrada)
+
+    bool Empty() const { return points.empty(); }
+    float Length() const { return arc.empty() ? 0.0f : arc.back(); }
+    float Spacing() const { return points.empty() ? 0.0f : Length() / points.size(); }
+
+    std::vector<glm::vec2> points;   // muestras densas de la spline cerrada (x, z)
+    std::vector<float> arc;          // longitud acumulada hasta points[i + 1]
+
+private:
+    float Sample(const cv::Mat& grid, float x, float z) const;
+    void UpdateArc();
+
+    cv::Mat field;     // CV_32F, distancia con signo en unidades del espacio del carro
+    cv::Mat height;    // CV_32F, altura del suelo
+    glm::vec2 origin = glm::vec2(0.0f);
+    float cellSize = 1.0f;
+};
+
+#endif
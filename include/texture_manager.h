@@ -0,0 +1,119 @@
+#ifndef TEXTURE_MANAGER_H
+#define TEXTURE_MANAGER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "asset_pack.h"
+
+// Textura dentro de un arreglo: array = -1 si no hay textura
+struct TextureRef {
+    int array = -1;
+    int layer = 0;
+};
+
+// Imagen lista para subir con toda su cadena de mipmaps: decodificada (los
+// niveles se calculan en CPU) o vista al paquete mapeado
+struct DecodedImage {
+    std::string path;
+    int width = 0, height = 0, levels = 0;
+    uint64_t hash = 0;
+    std::vector<unsigned char> pixels;   // niveles consecutivos
+    PackedTexture packed;
+
+    bool Valid() const { return width > 0; }
+    const unsigned char* Level(int level) const;
+};
+
+// Carga cada imagen una sola vez (por ruta y por contenido) y agrupa las del
+// mismo tamanio en un GL_TEXTURE_2D_ARRAY, un arreglo por tamanio.
+// La subida es progresiva: Upload deja solo el nivel 1x1 (color medio) y
+// Stream sube el resto de grueso a fino con un presupuesto de bytes por
+// frame. GL_TEXTURE_BASE_LEVEL limita el muestreo a los niveles completos.
+class TextureManager {
+public:
+    static const int MAX_ARRAYS = 4;   // samplers disponibles en el shader
+
+    struct Stats {
+        unsigned int references = 0;     // pedidos recibidos
+        unsigned int decoded = 0;        // imagenes decodificadas (rutas distintas)
+        unsigned int packed = 0;         // leidas del paquete, sin decodificar
+        unsigned int unique = 0;         // imagenes distintas por contenido
+        size_t decodedBytes = 0;
+        size_t decodeBytesSaved = 0;     // no decodificado gracias a la ruta repetida
+        size_t gpuBytes = 0;             // con mipmaps
+        size_t gpuBytesSaved = 0;        // frente a subir una textura por referencia
+    };
+
+    // Del ultimo Stream y acumulados
+    struct StreamStats {
+        size_t budget = 0;
+        size_t frameBytes = 0;           // subido en el ultimo frame
+        double frameMs = 0;              // tiempo de CPU de esas llamadas
+        size_t pendingBytes = 0;
+        size_t totalBytes = 0;
+        double maxFrameMs = 0;
+        unsigned int frames = 0;         // frames con subidas
+        unsigned int stalls = 0;         // frames por encima de STALL_MS
+    };
+    static constexpr double STALL_MS = 4.0;
+
+    static bool Decode(const std::string& path, const AssetPack* pack, DecodedImage& img);
+    // Sin OpenGL ni estado: se puede llamar desde cualquier hilo. Del paquete
+    // solo se toma una vista: Stream lee de ahi varios frames despues de
+    // Upload, asi que el paquete debe seguir abierto hasta que Streaming() sea false
+
+    TextureRef Add(DecodedImage&& img);
+    // Imagen ya decodificada (o solo la ruta, si ya se conoce); mismas rutas
+    // o mismo contenido comparten capa
+
+    void Upload();
+    // Crea los arreglos en la GPU y sube el nivel 1x1 de cada imagen
+
+    void Stream(size_t budgetBytes);
+    // Sube niveles pendientes (de grueso a fino, por franjas de filas) hasta
+    // agotar el presupuesto; libera los pixeles de cada imagen terminada
+    bool Streaming() const { return next < uploads.size(); }
+
+    void Bind(GLenum firstUnit = GL_TEXTURE0) const;
+    // Arreglo i en la unidad firstUnit + i
+
+    size_t ArrayCount() const { return arrays.size(); }
+    const Stats& GetStats() const { return stats; }
+    const StreamStats& GetStreamStats() const { return streamStats; }
+
+private:
+    struct Image {
+        DecodedImage data;
+        TextureRef ref;
+        int pendingLevels;
+    };
+    struct Array {
+        int width, height, layers;
+        GLuint id;
+        int levels;
+        int baseLevel;                      // nivel mas fino completo en todas las capas
+        std::vector<int> pendingLayers;     // por nivel
+    };
+    // Un nivel de una imagen, subido en una o varias franjas
+    struct LevelUpload {
+        int image, level;
+        int row;                            // primera fila pendiente
+    };
+
+    void UploadRows(LevelUpload& u, int rows);
+    void FinishLevel(const LevelUpload& u);
+
+    std::unordered_map<std::string, TextureRef> byPath;
+    std::unordered_map<uint64_t, TextureRef> byHash;
+    std::vector<Image> images;
+    std::vector<Array> arrays;
+    std::vector<LevelUpload> uploads;   // de grueso a fino
+    size_t next = 0;
+    Stats stats;
+    StreamStats streamStats;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef TRACK_BVH_H
+#define TRACK_BVH_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "mesh_data.h"
+
+struct TrackHit {
+    float t = 0.0f;
+    glm::vec3 point = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);   // normal geometrica unitaria, sin orientar
+    int triangle = -1;
+};
+
+// Jerarquia de cajas (AABB) sobre los triangulos de la pista.
+// Se construye una vez al cargar; las consultas no reservan memoria.
+class TrackBVH {
+public:
+    void Build(const MeshData& mesh, const glm::mat4& transform = glm::mat4(1.0f));
+    // transform lleva los vertices al espacio donde se haran las consultas
+
+    bool Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT, TrackHit& hit) const;
+    // Impacto mas cercano en [0, maxT]; dir no necesita ser unitario (t en unidades de dir)
+
+    bool RaycastBruteForce(const glm::vec3& origin, const glm::vec3& dir, float maxT, TrackHit& hit) const;
+    // Misma consulta probando todos los triangulos (referencia para el benchmark)
+
+    bool GroundHeight(const glm::vec3& p, const glm::vec3& up, float above, float below, TrackHit& hit) const;
+    // Suelo bajo p: rayo en -up desde p + up*above hasta p - up*below
+
+    bool Empty() const { return nodes.empty(); }
+    size_t NodeCount() const { return nodes.size(); }
+    size_t TriangleCount() const { return v0.size(); }
+    int Depth() const { return depth; }
+
+private:
+    static const int LEAF_SIZE = 4;
+
+    struct Node {
+        glm::vec3 bmin, bmax;
+        int left;    // hijo izquierdo (el derecho es left + 1), si count == 0
+        int first;   // primer triangulo, si es hoja
+        int count;   // triangulos en la hoja, 0 en nodos internos
+    };
+
+    bool IntersectTriangle(int tri, const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const;
+    void FillHit(int tri, const glm::vec3& origin, const glm::vec3& dir, float t, TrackHit& hit) const;
+
+    std::vector<Node> nodes;
+    // triangulos reordenados segun las hojas: v0 y aristas precalculadas
+    std::vector<glm::vec3> v0, e1, e2;
+    int depth = 0;
+};
+
+#endif
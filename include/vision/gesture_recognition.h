@@ -1,46 +1,129 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include "skin_lut.h"
+#include "hand_features.h"
+#include "gesture_tracker.h"
+#include "hand_classifier.h"
+#include "hand_background.h"
 
 using namespace cv;
 using namespace std;
 
+// Mano detectada en un frame
+struct HandDetection {
+    vector<Point> contour;
+    vector<Point> hull;
+    Vec4f line;
+    HandFeatures features;
+};
+
+// Mano seguida entre frames con ID estable (modo de varias manos)
+struct TrackedHand {
+    int id = 0;
+    int player = 0;          // ranura de jugador asignada al aparecer
+    HandDetection det;       // vacia si no se vio en el ultimo frame
+    Point2f lastCenter;      // centro de la ultima deteccion, se conserva al perderla
+    int missed = 0;          // frames seguidos sin verla
+    shared_ptr<GestureTracker> tracker;
+};
+
 class VisionProcessor {
 public:
-    Mat outFrame;
     Mat hsv;
     vector<Point> contour;
     vector<Point> hull;
     Vec4f fittingLine;
 
-    double solidity, defects, aspect, angle;
+    HandFeatures features;
+    Gesture gesture;            // clasificacion del ultimo frame, sin filtrar
     bool handDetected;
 
-    VisionProcessor();
+    // Clasificador punio / mano abierta (pesos fijos por defecto)
+    shared_ptr<HandClassifier> classifier;
+
+    // Gesto estable y cola de eventos de cambio de gesto
+    GestureTracker tracker;
+
+    // Resolucion de trabajo para la segmentacion (Size() = resolucion completa)
+    Size workSize;
+
+    // Procesar solo una ventana alrededor de la ultima mano detectada
+    bool useRoi;
+    double roiMargin;   // expansion del bounding box (fraccion de su tamanio)
+    double roiMinAreaRatio;   // blob menor que esto por el area anterior: buscar en todo el frame
+    Rect handBox;       // bounding box de la mano en coordenadas del frame
 
-    void processHand(const Mat& inFrame);
-    // Procesa el frame y dibuja convex hull + l�nea de ajuste
+    // Zona de busqueda de la mano y zona excluida, en coordenadas del frame (vacias = sin limite)
+    Rect searchRegion;
+    Rect excludeRegion;
 
-    // DETECCION DE MANO ABIERTA O CERRADA  
+    // Segmentacion de piel por tabla BGR (si esta lista) en lugar de HSV
+    SkinLut skinLut;
+    bool useSkinLut;
 
-    double calculateSolidity() const;
-    // Calcular si esta abierto o cerrado
+    // Seguimiento con flujo optico (LK) entre segmentaciones completas
+    bool useTracking;
+    int redetectInterval;     // segmentacion completa como maximo cada N frames
+    double minTrackRatio;     // fraccion minima de los puntos iniciales aun seguidos para confiar
+    bool lastFrameTracked;    // el ultimo frame se resolvio sin segmentar
 
-    double calculateAngle() const;
-    // Calcular la direccion del carro
+    // Orientacion por momentos del blob en lugar de fitLine sobre el contorno
+    bool useMomentOrientation;
 
-    double calculateAspect() const;
-    // Calculo de punio (forma cuadrada) o palma (forma rectangular)
+    // Blob mas grande por componentes conexas (sin contourArea por contorno)
+    bool useConnectedComponents;
 
-    double calculateDefects() const;
-    // Calculo de dedos
+    // Modelo de fondo opcional: la piel solo se busca en primer plano
+    HandBackground background;
+    bool useBackground;
 
-    void classifyHand();
+    // Varias manos (un jugador por mano); requiere useConnectedComponents,
+    // con maxHands > 1 no se usan ROI ni LK
+    int maxHands;
+    double minHandAreaRatio;  // area minima de una mano extra frente a la principal
+    int maxMissedFrames;      // frames sin ver una mano antes de olvidarla
+    vector<TrackedHand> hands;
 
-    void update();
+    // Estadisticas del ultimo frame segmentado
+    struct Stats {
+        int maskPixels = 0;   // pixeles de piel tras la morfologia
+        int blobs = 0;        // contornos candidatos
+    } stats;
+
+    VisionProcessor();
+
+    void processHand(const Mat& inFrame, const Mat& grayFull = Mat());
+    // Procesa el frame: contorno, convex hull y linea de ajuste (sin dibujar)
+    // grayFull: gris del frame completo si ya se calculo (modo de una camara)
+
+    void renderDebug(const Mat& inFrame, Mat& out) const;
+    // Imagen anotada para depuracion, solo cuando se pide (llamar despues de update)
+
+    void update(chrono::steady_clock::time_point t = chrono::steady_clock::now());
+    // Clasifica el gesto del ultimo frame y alimenta el tracker (t = instante de captura)
 
     bool isStop() const;
     bool isAdvance() const;
     bool isLeft() const;
     bool isRight() const;
+
+    const TrackedHand* handForPlayer(int player) const;
+    // Mano asignada a un jugador (nullptr si no hay)
+
+private:
+    void segmentHand(const Mat& inFrame, const Mat& gray, double scale);
+    void loseHand();
+    void updateFeatures();
+    HandDetection traceBlob(const Mat& labels, const Mat& ccStats, int label,
+                            const Rect& region, double scale) const;
+    void updateHands(const vector<HandDetection>& found, Size frameSize);
+    void startTracking(double scale);
+    bool trackHand(const Mat& gray, double scale);
+
+    Mat prevGray;                 // frame anterior en gris a la resolucion de trabajo
+    vector<Point2f> trackPts;     // puntos seguidos, coordenadas de trabajo
+    size_t trackStartCount;       // puntos al empezar el seguimiento (startTracking)
+    int framesSinceDetect;
+    int nextHandId;
 };
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include "hand_features.h"
+
+// Cambio de gesto estable, con el instante del frame de mano que lo produjo
+struct GestureEvent {
+    Gesture gesture = Gesture::None;
+    double confidence = 0.0;   // [0,1]
+    chrono::steady_clock::time_point time;
+};
+
+// Estabiliza la clasificacion por frame con histeresis y tiempo minimo de permanencia.
+// No es seguro entre hilos: update, poll y current van en el hilo de vision
+// (hoy el principal, junto con el juego).
+class GestureTracker {
+public:
+    using TimePoint = chrono::steady_clock::time_point;
+
+    double angleMargin;                  // banda de histeresis del angulo (grados)
+    double scoreMargin;                  // banda de histeresis del puntaje de punio
+    chrono::milliseconds minDwell;       // permanencia minima para cambiar de gesto
+    chrono::milliseconds lostTimeout;    // tiempo sin mano antes de pasar a None
+
+    GestureTracker();
+
+    void update(const HandFeatures& f, TimePoint t);
+    // Alimentar con los rasgos de cada frame de mano procesado
+
+    bool poll(GestureEvent& ev);
+    // Saca el siguiente evento de la cola (false si esta vacia)
+
+    Gesture current() const { return stable; }
+    void reset();
+
+private:
+    Gesture stable, candidate;
+    TimePoint candidateSince;
+
+    deque<GestureEvent> events;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+using namespace cv;
+using namespace std;
+
+// Modelo de fondo de la camara de mano: promedio movil en gris a resolucion de trabajo
+class HandBackground {
+public:
+    double learningRate;   // peso de cada actualizacion del promedio
+    int updateInterval;    // el modelo se actualiza cada N frames
+    int threshold;         // diferencia minima de gris para primer plano
+
+    HandBackground();
+
+    void update(const Mat& gray, const Rect& exclude = Rect());
+    // Frame completo en gris; la zona exclude (la mano) no se aprende
+
+    void foreground(const Mat& gray, const Rect& region, Mat& fg) const;
+    // Mascara de primer plano dentro de region (gris completo, mismo tamanio que el modelo)
+
+    bool ready() const { return !background.empty(); }
+    void reset();
+
+private:
+    Mat background;     // CV_32F
+    Mat background8u;
+    int frameCount;
+};
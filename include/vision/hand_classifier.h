@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "hand_features.h"
+
+// Rasgos que ven los clasificadores de punio / mano abierta
+const int HAND_FEATURE_COUNT = 4;
+typedef Vec<float, HAND_FEATURE_COUNT> HandFeatureVec;
+
+HandFeatureVec toFeatureVec(const HandFeatures& f);
+// solidity, defects, aspect, extent (area / area del bounding box)
+
+// Interfaz de los clasificadores de punio
+class HandClassifier {
+public:
+    virtual ~HandClassifier() {}
+
+    virtual double fistProbability(const HandFeatures& f) const = 0;
+    // Probabilidad de punio en [0,1] (>= 0.5 es STOP)
+
+    virtual const char* name() const = 0;
+};
+
+// Pesos ajustados a mano (FIST_*_WEIGHT), comportamiento original
+class WeightedClassifier : public HandClassifier {
+public:
+    double fistProbability(const HandFeatures& f) const override { return fistScore(f); }
+    const char* name() const override { return "pesos fijos"; }
+};
+
+// Regresion logistica sobre los rasgos estandarizados
+class LogisticClassifier : public HandClassifier {
+public:
+    HandFeatureVec mean, scale, weights;
+    float bias = 0.0f;
+
+    LogisticClassifier();
+
+    double fistProbability(const HandFeatures& f) const override;
+    double probability(const HandFeatureVec& x) const;
+    const char* name() const override { return "regresion logistica"; }
+
+    void train(const vector<HandFeatureVec>& X, const vector<int>& labels,
+               int iterations = 2000, float learningRate = 0.1f, float l2 = 1e-3f);
+    // Descenso de gradiente por lotes, labels: 1 = punio, 0 = abierta
+
+    bool save(const string& path) const;
+    bool load(const string& path);
+};
+
+shared_ptr<HandClassifier> loadHandClassifier(const string& path);
+// Modelo logistico del archivo o, si no existe, los pesos fijos
+
+// CSV de muestras etiquetadas: solidity,defects,aspect,extent,angle,label
+bool appendFeatureCsv(const string& path, const HandFeatures& f, int label);
+bool readFeatureCsv(const string& path, vector<HandFeatureVec>& X, vector<int>& labels);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+using namespace cv;
+using namespace std;
+
+// Gestos de control del carro
+enum class Gesture { None, Stop, Advance, Left, Right };
+
+// Rasgos de la mano, calculados una sola vez por frame
+struct HandFeatures {
+    bool detected = false;
+    double area = 0.0;       // area del contorno
+    double hullArea = 0.0;   // area del convex hull
+    double solidity = 0.0;   // area / hullArea (punio ~ 1)
+    double defects = 0.0;    // defectos de convexidad (dedos)
+    double aspect = 0.0;     // lado menor / lado mayor del bounding box (cuadrado = 1)
+    double angle = 0.0;      // orientacion de la mano en grados
+    Rect box;
+
+    double fist = 0.0;       // probabilidad de punio segun el clasificador activo
+};
+
+// Momentos hasta segundo orden de un blob, acumulados pixel a pixel
+struct BlobMoments {
+    double m00 = 0, m10 = 0, m01 = 0, m20 = 0, m11 = 0, m02 = 0;
+
+    void add(double x, double y) {
+        m00 += 1; m10 += x; m01 += y;
+        m20 += x * x; m11 += x * y; m02 += y * y;
+    }
+
+    void addRow(const uchar* row, int cols, int y);
+    // Acumula los pixeles != 0 de una fila
+};
+
+Vec4f orientationLine(const BlobMoments& m, Point2f offset = Point2f(), double scale = 1.0);
+// Eje principal en formato fitLine (vx, vy, x0, y0); el punto pasa a (p / scale + offset)
+
+HandFeatures extractHandFeatures(const vector<Point>& contour, const Vec4f& line, vector<Point>& hull);
+// Una sola pasada: indices del hull, areas, defectos, bounding box y orientacion
+
+// Terminos del puntaje de punio con los pesos fijos, cada uno en [0,1]
+struct FistTerms {
+    double solidity = 0.0, defects = 0.0, aspect = 0.0;
+};
+
+const double FIST_SOLIDITY_WEIGHT = 0.7;
+const double FIST_DEFECTS_WEIGHT = 0.2;
+const double FIST_ASPECT_WEIGHT = 0.1;
+
+FistTerms fistTerms(const HandFeatures& f);
+
+double fistScore(const HandFeatures& f);
+// Puntaje ponderado de punio con los pesos fijos (>= 0.5 es STOP)
+
+const double FIST_THRESHOLD = 0.5;
+const double ADVANCE_MIN_ANGLE = 50.0;   // |angulo| en (50, 90) es avanzar
+const double ADVANCE_MAX_ANGLE = 90.0;
+
+bool matchesGesture(const HandFeatures& f, Gesture g, double angleMargin = 0.0, double scoreMargin = 0.0);
+// Region de cada gesto, ensanchada por los margenes (histeresis)
+
+Gesture classifyGesture(const HandFeatures& f);
+// Funcion pura de los rasgos (usa f.fist para punio / abierta)
+
+const char* gestureName(Gesture g);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+// Tabla BGR -> probabilidad de piel, cuantizada a 32 niveles por canal
+class SkinLut {
+public:
+    static const int BITS = 5;
+    static const int BINS = 1 << BITS;
+    static const int SIZE = BINS * BINS * BINS;
+
+    SkinLut();
+
+    void buildFromHsvRange(const Scalar& lower, const Scalar& upper);
+    // Tabla equivalente al inRange HSV (valor por defecto)
+
+    void addSamples(const Mat& bgr, const Mat& skinMask);
+    // Acumula muestras etiquetadas: mask != 0 es piel, el resto fondo
+
+    void addCalibrationRoi(const Mat& bgr, const Rect& roi);
+    // La ROI se toma como piel y el resto del frame como fondo
+
+    void build();
+    // Calcula la probabilidad a partir de las muestras acumuladas
+
+    void clearSamples();
+
+    void setThreshold(int value);
+    // Probabilidad minima [0,255] para considerar un pixel como piel
+
+    void apply(const Mat& bgr, Mat& mask) const;
+    // Una lectura de tabla por pixel, filas en paralelo
+
+    bool save(const string& filename);
+    bool load(const string& filename);
+
+    bool reloadIfChanged();
+    // Recarga el archivo si cambio en disco (revisa como maximo 1 vez por segundo)
+
+    bool ready() const { return !binary.empty(); }
+
+    static int index(uchar b, uchar g, uchar r) {
+        return ((b >> (8 - BITS)) << (2 * BITS)) | ((g >> (8 - BITS)) << BITS) | (r >> (8 - BITS));
+    }
+
+private:
+    void updateBinary();
+
+    vector<uchar> prob;     // probabilidad de piel [0,255]
+    vector<uchar> binary;   // prob >= threshold ? 255 : 0
+    vector<float> skinCount, backCount;
+    int threshold;
+
+    string path;
+    filesystem::file_time_type loadedTime;
+    chrono::steady_clock::time_point lastCheck;
+};
@@ -0,0 +1,171 @@
+#include "../include/asset_loader.h"
+
+#include <algorithm>
+#include <iostream>
+#include "../include/mesh_lod.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+// Rutas de textura distintas de la malla, en orden de material
+std::vector<std::string> texturePaths(const MeshData& mesh) {
+    std::vector<std::string> paths;
+    for (const MeshMaterial& m : mesh.materials)
+        if (!m.texturePath.empty() && std::find(paths.begin(), paths.end(), m.texturePath) == paths.end())
+            paths.push_back(m.texturePath);
+    return paths;
+}
+
+// Del paquete (optimizada y con sus LODs horneados) o con Assimp, optimizada y
+// simplificada aqui; despues las versiones cuantizadas que se suben
+bool loadMesh(ModelAsset& asset, const AssetPack* pack) {
+    std::vector<MeshData> lods;
+    if (pack && pack->LoadMesh(asset.path, asset.mesh)) {
+        asset.meshStats.verticesBefore = asset.meshStats.verticesAfter = asset.mesh.VertexCount();
+        asset.meshStats.acmrBefore = asset.meshStats.acmrAfter = ComputeACMR(asset.mesh);
+        asset.meshStats.bytesBefore = FloatMeshBytes(asset.mesh);
+        if (!pack->LoadLods(asset.path, lods)) BuildLods(asset.mesh, lods);
+    } else if (LoadMeshData(asset.path, asset.mesh)) {
+        asset.meshStats = OptimizeMesh(asset.mesh);
+        asset.meshOptimized = true;
+        BuildLods(asset.mesh, lods);
+    } else {
+        return false;
+    }
+    asset.gpuLods.resize(lods.size() + 1);
+    BuildGpuMesh(asset.mesh, asset.gpuLods[0]);
+    for (size_t i = 0; i < lods.size(); i++) BuildGpuMesh(lods[i], asset.gpuLods[i + 1]);
+    asset.meshStats.bytesAfter = asset.gpuLods[0].Bytes();
+    return true;
+}
+}
+
+ModelAsset LoadModelAsset(const std::string& path, const AssetPack* pack) {
+    auto start = Clock::now();
+    ModelAsset asset;
+    asset.path = path;
+    asset.ok = loadMesh(asset, pack);
+    if (asset.ok) {
+        for (const std::string& tex : texturePaths(asset.mesh)) {
+            asset.images.emplace_back();
+            TextureManager::Decode(tex, pack, asset.images.back());
+            asset.images.back().path = tex;
+        }
+    }
+    asset.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return asset;
+}
+
+// ========== Pool ==========
+
+AssetLoader::AssetLoader(int workers) {
+    if (workers <= 0) workers = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    for (int i = 0; i < workers; i++)
+        threads.emplace_back(&AssetLoader::Run, this);
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        // lo pendiente se descarta (salida antes de recoger los modelos)
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        tasks.clear();
+    }
+    taskReady.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+void AssetLoader::Push(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskReady.notify_one();
+}
+
+void AssetLoader::Run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+int AssetLoader::Load(const std::string& path, const AssetPack* pack) {
+    auto job = std::make_unique<Job>();
+    job->asset.path = path;
+    job->pack = pack;
+    job->start = Clock::now();
+    Job* j = job.get();
+
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+        id = (int)jobs.size() - 1;
+    }
+    Push([this, j] { LoadMesh(j); });
+    return id;
+}
+
+void AssetLoader::LoadMesh(Job* job) {
+    ModelAsset& asset = job->asset;
+    asset.ok = loadMesh(asset, job->pack);
+    asset.imagesPending = true;
+
+    // cada tarea escribe solo en su imagen
+    std::vector<std::string> paths;
+    if (asset.ok) paths = texturePaths(asset.mesh);
+    job->images.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) job->images[i].path = paths[i];
+
+    std::lock_guard<std::mutex> lock(mutex);
+    asset.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - job->start).count();
+    job->meshDone = true;
+    job->imageState.assign(paths.size(), 0);
+    job->pending = (int)paths.size();
+    for (size_t i = 0; i < paths.size(); i++)
+        tasks.push_back([this, job, i] { DecodeImage(job, i); });
+    meshDone.notify_all();
+    taskReady.notify_all();
+}
+
+void AssetLoader::DecodeImage(Job* job, size_t i) {
+    DecodedImage& img = job->images[i];
+    std::string path = img.path;
+    TextureManager::Decode(path, job->pack, img);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    job->imageState[i] = 1;
+}
+
+ModelAsset AssetLoader::TakeMesh(int id) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!jobs[id] || jobs[id]->meshTaken) return ModelAsset();
+    meshDone.wait(lock, [&] { return jobs[id]->meshDone; });
+    jobs[id]->meshTaken = true;
+    return std::move(jobs[id]->asset);
+}
+
+bool AssetLoader::TakeImages(int id, std::vector<DecodedImage>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Job* job = jobs[id].get();
+    if (!job) return true;
+    if (!job->meshDone) return false;
+
+    for (size_t i = 0; i < job->images.size(); i++) {
+        if (job->imageState[i] != 1) continue;
+        out.push_back(std::move(job->images[i]));
+        job->imageState[i] = 2;
+        job->pending--;
+    }
+    if (job->pending > 0 || !job->meshTaken) return false;
+    jobs[id].reset();
+    return true;
+}
@@ -0,0 +1,363 @@
+#include "../include/asset_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "../include/mesh_lod.h"
+#include "../include/mesh_optimizer.h"
+#include "../include/stb_image.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace AssetPackFormat;
+
+namespace {
+size_t align16(size_t v) { return (v + 15) & ~size_t(15); }
+
+void copyName(char* dst, const std::string& src) {
+    std::memset(dst, 0, NAME_SIZE);
+    std::strncpy(dst, src.c_str(), NAME_SIZE - 1);
+}
+
+std::string lodName(const std::string& model, size_t level) { return model + "#lod" + std::to_string(level); }
+}
+
+uint64_t HashImage(int width, int height, const unsigned char* rgba, size_t size) {
+    uint64_t h = 14695981039346656037ull;
+    auto add = [&](const unsigned char* p, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    add(reinterpret_cast<const unsigned char*>(&width), sizeof(width));
+    add(reinterpret_cast<const unsigned char*>(&height), sizeof(height));
+    add(rgba, size);
+    return h;
+}
+
+// ========== Texturas empaquetadas ==========
+
+size_t PackedTexture::LevelBytes(int width, int height, int level) {
+    return (size_t)std::max(1, width >> level) * std::max(1, height >> level) * 4;
+}
+
+const unsigned char* PackedTexture::Level(int level) const {
+    const unsigned char* p = data;
+    for (int l = 0; l < level; l++) p += LevelBytes(width, height, l);
+    return p;
+}
+
+int MipLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+void BuildMipChain(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out) {
+    out.assign(rgba, rgba + (size_t)width * height * 4);
+    size_t prevOffset = 0;
+    int w = width, h = height;
+    while (w > 1 || h > 1) {
+        int nw = std::max(1, w / 2), nh = std::max(1, h / 2);
+        size_t offset = out.size();
+        out.resize(offset + (size_t)nw * nh * 4);
+        const unsigned char* src = out.data() + prevOffset;
+        unsigned char* dst = out.data() + offset;
+
+        // caja 2x2 (1x2 o 2x1 en los bordes de texturas no cuadradas)
+        for (int y = 0; y < nh; y++) {
+            int y0 = std::min(2 * y, h - 1), y1 = std::min(2 * y + 1, h - 1);
+            for (int x = 0; x < nw; x++) {
+                int x0 = std::min(2 * x, w - 1), x1 = std::min(2 * x + 1, w - 1);
+                for (int c = 0; c < 4; c++) {
+                    int sum = src[(y0 * w + x0) * 4 + c] + src[(y0 * w + x1) * 4 + c] +
+                              src[(y1 * w + x0) * 4 + c] + src[(y1 * w + x1) * 4 + c];
+                    dst[(y * nw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        prevOffset = offset;
+        w = nw;
+        h = nh;
+    }
+}
+
+// ========== Lectura ==========
+
+bool AssetPack::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    base = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    size = (size_t)fileSize.QuadPart;
+    fileHandle = file;
+    mappingHandle = mapping;
+    if (!base) {
+        Close();
+        return false;
+    }
+#else
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        Close();
+        return false;
+    }
+    size = (size_t)st.st_size;
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    base = static_cast<const unsigned char*>(p);
+#endif
+
+    // encabezado e indice
+    Header header;
+    if (size < sizeof(Header)) {
+        Close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, 4) != 0 || header.version != VERSION ||
+        header.indexOffset + (uint64_t)header.entryCount * sizeof(IndexEntry) > size) {
+        std::cerr << "AssetPack: paquete invalido o de otra version: " << path << "\n";
+        Close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        IndexEntry e;
+        std::memcpy(&e, base + header.indexOffset + i * sizeof(IndexEntry), sizeof(IndexEntry));
+        e.name[NAME_SIZE - 1] = '\0';
+        if (e.offset + e.size > size) continue;
+        index[e.name] = { e.type, e.offset, e.size };
+    }
+    std::cout << "Paquete de recursos abierto: " << path << " (" << index.size() << " entradas, "
+              << size / (1024 * 1024) << " MB)\n";
+    return true;
+}
+
+bool AssetPack::IsOutdated(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    Header header;
+    if (!f.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    return std::memcmp(header.magic, MAGIC, 4) == 0 && header.version != VERSION;
+}
+
+void AssetPack::Close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (base) munmap(const_cast<unsigned char*>(base), size);
+    if (fd >= 0) close(fd);
+    fd = -1;
+#endif
+    base = nullptr;
+    size = 0;
+    index.clear();
+}
+
+const AssetPack::Entry* AssetPack::Find(const std::string& name, uint32_t type) const {
+    auto it = index.find(name);
+    return it != index.end() && it->second.type == type ? &it->second : nullptr;
+}
+
+bool AssetPack::LoadMesh(const std::string& name, MeshData& mesh) const {
+    const Entry* e = Find(name, TYPE_MESH);
+    return e && ReadMesh(*e, mesh);
+}
+
+bool AssetPack::LoadLods(const std::string& name, std::vector<MeshData>& lods) const {
+    lods.clear();
+    for (size_t level = 1;; level++) {
+        const Entry* e = Find(lodName(name, level), TYPE_MESH_LOD);
+        if (!e) break;
+        lods.emplace_back();
+        if (!ReadMesh(*e, lods.back())) {
+            lods.clear();
+            return false;
+        }
+    }
+    return !lods.empty();
+}
+
+bool AssetPack::ReadMesh(const Entry& e, MeshData& mesh) const {
+    if (e.size < sizeof(MeshHeader)) return false;
+
+    const unsigned char* p = base + e.offset;
+    MeshHeader h;
+    std::memcpy(&h, p, sizeof(h));
+    size_t needed = sizeof(h) + (size_t)h.vertexCount * MeshData::VERTEX_STRIDE * sizeof(float) +
+                    (size_t)h.indexCount * sizeof(unsigned int) + h.materialCount * sizeof(MaterialRecord) +
+                    h.rangeCount * sizeof(DrawRange);
+    if (needed > e.size) return false;
+    p += sizeof(h);
+
+    const float* verts = reinterpret_cast<const float*>(p);
+    mesh.vertices.assign(verts, verts + (size_t)h.vertexCount * MeshData::VERTEX_STRIDE);
+    p += (size_t)h.vertexCount * MeshData::VERTEX_STRIDE * sizeof(float);
+
+    const unsigned int* idx = reinterpret_cast<const unsigned int*>(p);
+    mesh.indices.assign(idx, idx + h.indexCount);
+    p += (size_t)h.indexCount * sizeof(unsigned int);
+
+    mesh.materials.resize(h.materialCount);
+    for (uint32_t i = 0; i < h.materialCount; i++, p += sizeof(MaterialRecord)) {
+        MaterialRecord m;
+        std::memcpy(&m, p, sizeof(m));
+        m.texturePath[NAME_SIZE - 1] = '\0';
+        mesh.materials[i].texturePath = m.texturePath;
+        std::copy(m.diffuse, m.diffuse + 3, mesh.materials[i].diffuse);
+    }
+
+    mesh.ranges.resize(h.rangeCount);
+    std::memcpy(mesh.ranges.data(), p, h.rangeCount * sizeof(DrawRange));
+    return true;
+}
+
+bool AssetPack::FindTexture(const std::string& name, PackedTexture& tex) const {
+    const Entry* e = Find(name, TYPE_TEXTURE);
+    if (!e || e->size < sizeof(TextureHeader)) return false;
+
+    TextureHeader h;
+    std::memcpy(&h, base + e->offset, sizeof(h));
+    size_t needed = sizeof(h);
+    for (uint32_t l = 0; l < h.levels; l++) needed += PackedTexture::LevelBytes(h.width, h.height, l);
+    if (needed > e->size) return false;
+
+    tex.width = (int)h.width;
+    tex.height = (int)h.height;
+    tex.levels = (int)h.levels;
+    tex.hash = h.hash;
+    tex.data = base + e->offset + sizeof(h);
+    return true;
+}
+
+// ========== Escritura ==========
+
+bool WriteAssetPack(const std::string& path, const std::vector<std::string>& models) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+
+    std::vector<IndexEntry> entries;
+    size_t offset = align16(sizeof(Header));
+    Header header = {};
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    auto beginEntry = [&](const std::string& name, uint32_t type) {
+        std::vector<char> pad(offset - (size_t)f.tellp(), 0);
+        f.write(pad.data(), pad.size());
+        IndexEntry e = {};
+        copyName(e.name, name);
+        e.type = type;
+        e.offset = offset;
+        entries.push_back(e);
+    };
+    auto endEntry = [&]() {
+        size_t end = (size_t)f.tellp();
+        entries.back().size = end - entries.back().offset;
+        offset = align16(end);
+    };
+
+    // mallas completas y LODs comparten formato: encabezado, vertices, indices, materiales, rangos
+    auto writeMesh = [&](const std::string& name, uint32_t type, const MeshData& mesh) {
+        beginEntry(name, type);
+        MeshHeader h = { (uint32_t)mesh.VertexCount(), (uint32_t)mesh.indices.size(),
+                         (uint32_t)mesh.materials.size(), (uint32_t)mesh.ranges.size() };
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        f.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(float));
+        f.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+        for (const MeshMaterial& m : mesh.materials) {
+            MaterialRecord r = {};
+            copyName(r.texturePath, m.texturePath);
+            std::copy(m.diffuse, m.diffuse + 3, r.diffuse);
+            f.write(reinterpret_cast<const char*>(&r), sizeof(r));
+        }
+        f.write(reinterpret_cast<const char*>(mesh.ranges.data()), mesh.ranges.size() * sizeof(DrawRange));
+        endEntry();
+    };
+
+    std::vector<std::string> textures;
+    for (const std::string& model : models) {
+        MeshData mesh;
+        if (!LoadMeshData(model, mesh)) return false;
+        MeshOptStats opt = OptimizeMesh(mesh);
+        std::cout << model << ": " << opt.verticesBefore << " -> " << opt.verticesAfter << " vertices, ACMR "
+                  << opt.acmrBefore << " -> " << opt.acmrAfter << "\n";
+
+        writeMesh(model, TYPE_MESH, mesh);
+        for (const MeshMaterial& m : mesh.materials)
+            if (!m.texturePath.empty() && std::find(textures.begin(), textures.end(), m.texturePath) == textures.end())
+                textures.push_back(m.texturePath);
+
+        // LODs horneados: en el juego solo queda cuantizarlos
+        std::vector<MeshData> lods;
+        BuildLods(mesh, lods);
+        for (size_t i = 0; i < lods.size(); i++) writeMesh(lodName(model, i + 1), TYPE_MESH_LOD, lods[i]);
+        std::cout << "  " << lods.size() << " LODs\n";
+    }
+
+    std::vector<unsigned char> chain;
+    for (const std::string& texPath : textures) {
+        int width, height, channels;
+        unsigned char* data = stbi_load(texPath.c_str(), &width, &height, &channels, 4);
+        if (!data) {
+            std::cerr << "AssetPack: no se pudo cargar la textura " << texPath << ", se omite\n";
+            continue;
+        }
+        BuildMipChain(data, width, height, chain);
+
+        TextureHeader h = {};
+        h.width = (uint32_t)width;
+        h.height = (uint32_t)height;
+        h.levels = (uint32_t)MipLevelCount(width, height);
+        h.hash = HashImage(width, height, data, (size_t)width * height * 4);
+        stbi_image_free(data);
+
+        beginEntry(texPath, TYPE_TEXTURE);
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        f.write(reinterpret_cast<const char*>(chain.data()), chain.size());
+        endEntry();
+    }
+
+    // indice al final y encabezado definitivo
+    std::vector<char> pad(offset - (size_t)f.tellp(), 0);
+    f.write(pad.data(), pad.size());
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.entryCount = (uint32_t)entries.size();
+    header.indexOffset = offset;
+    f.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(IndexEntry));
+    f.seekp(0);
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return (bool)f;
+}
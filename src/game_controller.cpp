@@ -4,6 +4,9 @@
 #include "../include/game_controller.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 using Clock = std::chrono::steady_clock;
 
@@ -24,43 +27,314 @@ static glm::mat4 cvPoseToView(const cv::Mat& rvec, const cv::Mat& tvec) {
             view[c][r] = static_cast<float>(viewCV.at<double>(r, c));
     return view;
 }
+
+// Transformacion de la pista en el espacio del marcador
+static glm::mat4 pistaModelMatrix() {
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::scale(model, glm::vec3(2.0f));
+    model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1, 0, 0));
+    model = glm::translate(model, glm::vec3(0.3f, -0.2f, -0.2f));
+    return model;
+}
+
+// Clave de instancia de cada carro dibujado (estado de LOD estable aunque
+// cambie cuantos se dibujan en el frame)
+enum TipoCarro { CARRO_JUGADOR = 0, CARRO_RIVAL = 1, CARRO_FANTASMA = 2 };
+int claveCarro(TipoCarro tipo, size_t i) {
+    return (int)tipo << 16 | (int)i;
+}
+
+// Espacio del carro: la simulacion vive aqui, con +y hacia arriba
+static glm::mat4 carroBaseMatrix() {
+    glm::mat4 model = glm::scale(glm::mat4(1.0f), glm::vec3(0.2f));
+    return glm::rotate(model, glm::radians(90.0f), glm::vec3(1, 0, 0));
+}
 }
 GameController::GameController(ModelRenderer& rend, VisionProcessor& vis,
-                               const cv::Mat& K_, const cv::Mat& dist_)
-    : renderer(rend), vision(vis), position(0.0f), accion("Sin gesto"),
+                               const cv::Mat& K_, const cv::Mat& dist_, int numJugadores)
+    : renderer(rend), vision(vis), jugadores(std::max(1, numJugadores)),
+      tickRate(60.0), acumulador(0.0), alpha(0.0), ticks(0), lastUpdateTime(Clock::now()),
       hasLastPose(false), lastDetectionTime(Clock::now()),
-      K(K_.clone()), dist(dist_.clone()) {}
+      K(K_.clone()), dist(dist_.clone()) {
+    if (jugadores.size() > 1) vision.maxHands = (int)jugadores.size();
+    for (size_t i = 0; i < jugadores.size(); i++)
+        jugadores[i].estado = jugadores[i].estadoPrevio = estadoInicial(i);
+}
+
+GameController::~GameController() {
+    if (guardadoFantasma.joinable()) guardadoFantasma.join();
+}
 
 
 void GameController::process(cv::Mat& frameMarker, cv::Mat& frameHand) {
-    procesarFrame(frameMarker, K, dist, pose);
+    procesarMarcador(frameMarker, cv::Mat());
+    procesarMano(frameHand, cv::Mat());
+    actualizarJuego();
+}
+
+void GameController::process(cv::Mat& frame) {
+    // una sola conversion a gris para el marcador y la mano
+    cv::Mat gray;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+
+    // la mano no se busca sobre el ultimo marcador visto
+    vision.excludeRegion = cv::Rect();
+    if (pose.poseValida && pose.esquinas.size() == 4) {
+        cv::Rect marker = cv::boundingRect(pose.esquinas);
+        int dx = marker.width / 4, dy = marker.height / 4;
+        vision.excludeRegion = cv::Rect(marker.x - dx, marker.y - dy,
+                                        marker.width + 2 * dx, marker.height + 2 * dy);
+    }
+
+    // primero la mano: procesarFrame dibuja los ejes sobre el frame
+    procesarMano(frame, gray);
+    procesarMarcador(frame, gray);
+    actualizarJuego();
+}
+
+void GameController::procesarMarcador(cv::Mat& frame, const cv::Mat& gray) {
+    if (gray.empty()) procesarFrame(frame, K, dist, pose);
+    else procesarFrame(frame, gray, K, dist, pose);
+
     if (pose.poseValida) {
         lastPose = pose;
         hasLastPose = true;
         lastDetectionTime = Clock::now();
     }
+}
 
-    vision.processHand(frameHand);
-    vision.update();
+void GameController::procesarMano(const cv::Mat& frame, const cv::Mat& gray) {
+    auto handTime = Clock::now();
+    vision.processHand(frame, gray);
+    vision.update(handTime);
 
-    double elapsed = std::chrono::duration<double>(Clock::now() - lastDetectionTime).count();
-    if (!(hasLastPose && elapsed < 2.0)) {
-        accion = "Sin gesto";
-        return;
-    }
-
-    const float step = 0.05f;
-    if (vision.isAdvance()) {
-        position.z += step;  accion = "Arriba";
-    } else if (vision.isLeft()) {
-        position.x -= step;  accion = "Izquierda";
-    } else if (vision.isRight()) {
-        position.x += step;  accion = "Derecha";
-    } else if (vision.isStop()) {
-        position.z -= step;  accion = "Abajo";
+    // solo cambios de gesto ya estabilizados por el tracker de cada mano
+    for (size_t i = 0; i < jugadores.size(); i++) {
+        Jugador& j = jugadores[i];
+        GestureTracker* tracker = &vision.tracker;
+        if (jugadores.size() > 1) {
+            const TrackedHand* hand = vision.handForPlayer((int)i);
+            if (!hand) {
+                j.gesto = Gesture::None;
+                continue;
+            }
+            tracker = hand->tracker.get();
+        }
+
+        GestureEvent ev;
+        while (tracker->poll(ev)) {
+            j.gesto = ev.gesture;
+            j.gestoConfianza = ev.confidence;
+        }
+    }
+}
+
+void GameController::actualizarJuego() {
+    auto now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastDetectionTime).count();
+    bool activo = hasLastPose && elapsed < 2.0;
+
+    for (Jugador& j : jugadores) {
+        if (!activo)                          j.accion = "Sin gesto";
+        else if (j.gesto == Gesture::Advance) j.accion = "Acelerar";
+        else if (j.gesto == Gesture::Left)    j.accion = "Izquierda";
+        else if (j.gesto == Gesture::Right)   j.accion = "Derecha";
+        else if (j.gesto == Gesture::Stop)    j.accion = "Frenar";
+        else                                  j.accion = "Sin gesto";
+    }
+
+    // acumulador: tantos ticks fijos como tiempo real haya pasado
+    const double dt = 1.0 / tickRate;
+    const int maxTicksPorFrame = 8;   // evita la espiral si un frame tarda demasiado
+    acumulador += std::min(std::chrono::duration<double>(now - lastUpdateTime).count(), maxTicksPorFrame * dt);
+    lastUpdateTime = now;
+
+    while (acumulador >= dt) {
+        // intervalo del tick en el reloj de simulacion
+        double t0 = ticks * dt, t1 = (ticks + 1) * dt;
+
+        for (size_t i = 0; i < jugadores.size(); i++) {
+            Jugador& j = jugadores[i];
+            j.estadoPrevio = j.estado;
+            tick(j.estado, j.gesto, activo, (float)dt);
+
+            const glm::vec3& a = j.estadoPrevio.position;
+            const glm::vec3& b = j.estado.position;
+            int vuelta = cronometro.Gates().empty() ? 0 : cronometro.GetRacer(i).lap;
+            bool completa = cronometro.Update(i, glm::vec2(a.x, a.z), glm::vec2(b.x, b.z), t0, t1);
+            if (completa) {
+                const LapTimer::Racer& r = cronometro.GetRacer(i);
+                std::cout << "J" << i + 1 << " vuelta " << r.lap - 1 << ": " << r.lastLap << " s"
+                          << (r.lastLapValid ? "" : " (invalida: compuertas saltadas)") << "\n";
+            }
+            if (i == 0 && activo) {
+                bool iniciada = !cronometro.Gates().empty() && cronometro.GetRacer(0).lap != vuelta;
+                grabarFantasma(iniciada, completa, t1);
+            }
+        }
+        if (activo && oponentes.Size() > 0) {
+            auto start = Clock::now();
+            oponentes.Update(lineaCarrera, (float)dt);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            oponentesMs = 0.95 * oponentesMs + 0.05 * ms;
+
+            const Opponents& o = oponentes;
+            for (size_t i = 0; i < o.Size(); i++)
+                cronometro.Update(jugadores.size() + i, glm::vec2(o.prevX[i], o.prevZ[i]), glm::vec2(o.x[i], o.z[i]), t0, t1);
+        }
+        acumulador -= dt;
+        if (activo) ticks++;   // en pausa (sin marcador) el reloj de carrera no avanza
+    }
+    alpha = acumulador / dt;
+
+    if (fantasmaPendiente) guardarFantasma();
+}
+
+void GameController::guardarFantasma() {
+    fantasmaPendiente = false;
+    if (guardadoFantasma.joinable()) guardadoFantasma.join();
+
+    // copia: la pista de fantasmaMejor puede cambiar mientras se escribe
+    guardadoFantasma = std::thread([track = fantasmaMejor.Track(), path = fantasmaPath]() {
+        if (track.Save(path))
+            std::cout << "Fantasma guardado: " << track.frameCount << " cuadros, "
+                      << track.Bytes() << " bytes\n";
+    });
+}
+
+GameController::EstadoCarro GameController::estadoInicial(size_t jugador) const {
+    // cada jugador arranca en su propio carril
+    EstadoCarro e;
+    e.position = glm::vec3(1.5f * jugador, 0.0f, 0.0f);
+    return e;
+}
+
+void GameController::tick(EstadoCarro& estado, Gesture gesto, bool activo, float dt) {
+    if (!activo) return;
+    const ParametrosVehiculo& p = vehiculo;
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+    // volante: se mueve hacia el gesto con tasa limitada
+    float objetivo = gesto == Gesture::Left ? -1.0f : gesto == Gesture::Right ? 1.0f : 0.0f;
+    float maxCambio = p.tasaVolante * dt;
+    estado.steer += std::max(-maxCambio, std::min(maxCambio, objetivo - estado.steer));
+
+    // acelerador / freno / reversa
+    float& v = estado.speed;
+    if (gesto == Gesture::Advance) {
+        v += p.aceleracion * dt;
+    } else if (gesto == Gesture::Stop) {
+        v -= (v > 0.0f ? p.frenado : p.aceleracion) * dt;
     } else {
-        accion = "Sin gesto";
+        float a = p.arrastre * dt;
+        v = v > 0.0f ? std::max(0.0f, v - a) : std::min(0.0f, v + a);
+    }
+    float vMax = estado.enPista ? p.velocidadMax : p.velocidadMax * p.factorFueraPista;
+    v = std::max(-p.velocidadReversa, std::min(vMax, v));
+
+    // el giro depende de la velocidad: parado no gira
+    float factorGiro = std::min(1.0f, std::fabs(v) / (0.5f * p.velocidadMax));
+    estado.heading += estado.steer * p.giroMax * factorGiro * (v < 0.0f ? -1.0f : 1.0f) * dt;
+
+    glm::vec3 forward(std::sin(estado.heading), 0.0f, std::cos(estado.heading));
+    glm::vec3 delta = forward * (v * dt);
+
+    if (!pistaBvh.Empty() && v != 0.0f) {
+        // paredes: triangulos casi verticales en la direccion del movimiento
+        glm::vec3 origin = estado.position + up * (0.5f * p.radio);
+        float dist = glm::length(delta);
+        TrackHit hit;
+        if (pistaBvh.Raycast(origin, delta / dist, dist + p.radio, hit) && std::fabs(glm::dot(hit.normal, up)) < 0.5f) {
+            // deslizar a lo largo de la pared y perder velocidad
+            delta -= glm::dot(delta, hit.normal) * hit.normal;
+            delta.y = 0.0f;
+            v *= 0.5f;
+            float slide = glm::length(delta);
+            if (slide > 0.0f && pistaBvh.Raycast(origin, delta / slide, slide + p.radio, hit) &&
+                std::fabs(glm::dot(hit.normal, up)) < 0.5f)
+                delta = glm::vec3(0.0f);
+        }
+    }
+    estado.position += delta;
+
+    if (!pistaBvh.Empty()) {
+        // seguir la altura del suelo; sin suelo debajo el carro esta fuera de la pista
+        TrackHit suelo;
+        estado.enPista = pistaBvh.GroundHeight(estado.position, up, p.alturaRayo, p.alturaRayo, suelo);
+        if (estado.enPista) estado.position.y = suelo.point.y;
+    }
+}
+
+void GameController::setPista(const ModelRenderer& pistaRenderer, const std::string& cachePath) {
+    glm::mat4 transform = glm::inverse(carroBaseMatrix()) * pistaModelMatrix();
+    auto t0 = Clock::now();
+    pistaBvh.Build(pistaRenderer.GetMesh(), transform);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "BVH de la pista: " << pistaBvh.TriangleCount() << " triangulos, "
+              << pistaBvh.NodeCount() << " nodos, profundidad " << pistaBvh.Depth()
+              << " (" << ms << " ms)\n";
+
+    if (lineaCarrera.LoadOrBake(cachePath, pistaRenderer.GetMesh(), transform))
+        oponentes.Reset(lineaCarrera, numOponentes);
+    reiniciarCronometro();
+}
+
+void GameController::setOponentes(int n) {
+    numOponentes = std::max(0, n);
+    oponentes.Reset(lineaCarrera, numOponentes);
+    reiniciarCronometro();
+}
+
+void GameController::setCheckpoints(const std::string& path) {
+    if (!cronometro.Load(path, glm::inverse(carroBaseMatrix()))) {
+        cronometro.GenerateFromLine(lineaCarrera, 12, 4);
+        if (cronometro.Save(path, carroBaseMatrix()))
+            std::cout << "Compuertas generadas desde la linea de carrera en " << path << "\n";
     }
+    reiniciarCronometro();
+}
+
+void GameController::reiniciarCronometro() {
+    cronometro.ResetRacers(jugadores.size() + oponentes.Size());
+    grabador.Stop();
+}
+
+void GameController::setFantasma(const std::string& path) {
+    fantasmaPath = path;
+    GhostTrack track;
+    if (track.Load(path)) {
+        fantasmaMejor.SetTrack(track);
+        std::cout << "Fantasma cargado: vuelta de " << track.lapTime << " s, "
+                  << track.frameCount << " cuadros, " << track.Bytes() << " bytes\n";
+    }
+}
+
+void GameController::grabarFantasma(bool vueltaIniciada, bool vueltaCompleta, double t1) {
+    const LapTimer::Racer& r = cronometro.GetRacer(0);
+
+    if (vueltaCompleta && grabador.Recording()) {
+        GhostTrack& track = grabador.Track();
+        track.lapTime = r.lastLap;
+        fantasmaUltima.SetTrack(track);
+
+        const GhostTrack& mejor = fantasmaMejor.Track();
+        if (r.lastLapValid && (mejor.lapTime < 0.0 || track.lapTime < mejor.lapTime)) {
+            fantasmaMejor.SetTrack(track);
+            fantasmaPendiente = !fantasmaPath.empty();
+        }
+    }
+    if (vueltaIniciada) grabador.Start((float)tickRate, (float)(t1 - r.lapStart));
+
+    const EstadoCarro& e = jugadores[0].estado;
+    grabador.Add(e.position, e.heading);
+}
+
+void GameController::setTickRate(double hz) {
+    tickRate = std::max(1.0, hz);
+}
+
+double GameController::getSimTime() const {
+    return ticks / tickRate;
 }
 
 void GameController::drawModel(const glm::mat4& projection) {
@@ -68,43 +342,116 @@ void GameController::drawModel(const glm::mat4& projection) {
     double elapsed = std::chrono::duration<double>(Clock::now() - lastDetectionTime).count();
     if (elapsed >= 2.0) return;
 
-    glm::mat4 model = glm::scale(glm::mat4(1.0f), glm::vec3(0.2f));
-    model = glm::rotate(model, glm::radians(90.0f),  glm::vec3(1,0,0));
-    model = glm::translate(model, position);
-    
-    model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.05f));
-
     glm::mat4 view = cvPoseToView(lastPose.rvec, lastPose.tvec);
-
     renderer.SetViewProjection(view, projection);
-    renderer.SetModelMatrix(model);
-    renderer.Draw();
+
+    for (size_t i = 0; i < jugadores.size(); i++) {
+        glm::mat4 model = carroBaseMatrix();
+        // interpolacion entre los dos ultimos ticks
+        const Jugador& j = jugadores[i];
+        glm::vec3 position = glm::mix(j.estadoPrevio.position, j.estado.position, (float)alpha);
+        float heading = glm::mix(j.estadoPrevio.heading, j.estado.heading, (float)alpha);
+        model = glm::translate(model, position);
+        model = glm::rotate(model, heading, glm::vec3(0, 1, 0));
+        model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.05f));
+
+        renderer.SetModelMatrix(model);
+        renderer.Draw(claveCarro(CARRO_JUGADOR, i));
+    }
+
+    for (size_t i = 0; i < oponentes.Size(); i++) {
+        const Opponents& o = oponentes;
+        glm::vec3 position = glm::mix(glm::vec3(o.prevX[i], o.prevY[i], o.prevZ[i]),
+                                      glm::vec3(o.x[i], o.y[i], o.z[i]), (float)alpha);
+        float heading = glm::mix(o.prevHeading[i], o.heading[i], (float)alpha);
+        glm::mat4 model = glm::translate(carroBaseMatrix(), position);
+        model = glm::rotate(model, heading, glm::vec3(0, 1, 0));
+        model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.05f));
+
+        renderer.SetModelMatrix(model);
+        renderer.Draw(claveCarro(CARRO_RIVAL, i));
+    }
+
+    // fantasmas al final (translucidos), en el mismo tiempo de vuelta que el jugador 1
+    if (!cronometro.Gates().empty() && cronometro.GetRacer(0).lap > 0) {
+        // el jugador se dibuja entre estadoPrevio y estado: (ticks - 1 + alpha) * dt
+        double tiempoVuelta = getSimTime() - (1.0 - alpha) / tickRate - cronometro.GetRacer(0).lapStart;
+        renderer.SetAlpha(0.35f);
+        GhostPlayer* fantasmas[] = { &fantasmaMejor, &fantasmaUltima };
+        for (size_t f = 0; f < 2; f++) {
+            GhostPlayer* fantasma = fantasmas[f];
+            glm::vec3 position;
+            float heading;
+            if (!fantasma->Sample(tiempoVuelta, position, heading)) continue;
+
+            glm::mat4 model = glm::translate(carroBaseMatrix(), position);
+            model = glm::rotate(model, heading, glm::vec3(0, 1, 0));
+            model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.05f));
+            renderer.SetModelMatrix(model);
+            renderer.Draw(claveCarro(CARRO_FANTASMA, f));
+        }
+        renderer.SetAlpha(1.0f);
+    }
 }
 
 std::string GameController::getStatusText() const {
-    char buf[128];
-    snprintf(buf, sizeof(buf), "Gesto: %s | Pos x=%.2f y=%.2f z=%.2f",
-             accion.c_str(), position.x, position.y, position.z);
-    return std::string(buf);
+    std::string text;
+    for (size_t i = 0; i < jugadores.size(); i++) {
+        const Jugador& j = jugadores[i];
+        const glm::vec3& position = j.estado.position;
+        char buf[128];
+        if (jugadores.size() == 1)
+            snprintf(buf, sizeof(buf), "Gesto: %s (%.0f%%) | Pos x=%.2f y=%.2f z=%.2f | v=%.2f%s",
+                     j.accion.c_str(), j.gestoConfianza * 100.0, position.x, position.y, position.z,
+                     j.estado.speed, j.estado.enPista ? "" : " (fuera)");
+        else
+            snprintf(buf, sizeof(buf), "%sJ%d: %s (%.0f%%) x=%.2f z=%.2f v=%.2f", i ? " | " : "",
+                     (int)i + 1, j.accion.c_str(), j.gestoConfianza * 100.0, position.x, position.z, j.estado.speed);
+        text += buf;
+    }
+    if (!cronometro.Gates().empty()) {
+        // tiempos del jugador 1
+        const LapTimer::Racer& r = cronometro.GetRacer(0);
+        char buf[128];
+        double t = getSimTime() - r.lapStart;
+        if (r.lap == 0)
+            snprintf(buf, sizeof(buf), " | Cruza la salida");
+        else if (r.bestLap < 0.0)
+            snprintf(buf, sizeof(buf), " | Vuelta %d: %.2f s", r.lap, t);
+        else
+            snprintf(buf, sizeof(buf), " | Vuelta %d: %.2f s (mejor %.2f)", r.lap, t, r.bestLap);
+        text += buf;
+        for (size_t s = 0; s < r.lastSectors.size(); s++) {
+            snprintf(buf, sizeof(buf), " S%d %.2f", (int)s + 1, r.lastSectors[s]);
+            text += buf;
+        }
+        if (r.wrongWay) text += " | CONTRAMANO";
+        else if (r.skipped > 0) text += " | Vuelta invalida";
+    }
+    if (oponentes.Size() > 0) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), " | IA: %d (%.3f ms)", (int)oponentes.Size(), oponentesMs);
+        text += buf;
+    }
+    return text;
 }
 
-glm::vec3 GameController::getPosition() const { return position; }
+glm::vec3 GameController::getPosition() const { return jugadores[0].estado.position; }
 
 void GameController::resetPosition() {
-    position   = glm::vec3(0.0f);
-    accion     = "Reset";
+    for (size_t i = 0; i < jugadores.size(); i++) {
+        Jugador& j = jugadores[i];
+        j.estado = j.estadoPrevio = estadoInicial(i);
+        j.accion = "Reset";
+    }
+    oponentes.Reset(lineaCarrera, numOponentes);
+    reiniciarCronometro();
 }
 
 void GameController::drawStaticPista(const glm::mat4& projection, ModelRenderer& pistaRenderer) {
     if (!hasLastPose) return;
 
-    glm::mat4 model = glm::mat4(1.0f);
-
-    model = glm::scale(model, glm::vec3(2.0f));
-
-    model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1, 0, 0));
-    model = glm::translate(model, glm::vec3(0.3f, -0.2f, -0.2f));
-
+    glm::mat4 model = pistaModelMatrix();
     glm::mat4 view = cvPoseToView(lastPose.rvec, lastPose.tvec);
 
     pistaRenderer.SetViewProjection(view, projection);
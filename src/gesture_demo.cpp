@@ -10,7 +10,7 @@ int main() {
         return -1;
     }
 
-    Mat frame;
+    Mat frame, debug;
     VisionProcessor vp;
 
     while (true) {
@@ -18,9 +18,11 @@ int main() {
         if (frame.empty()) break;
 
         vp.processHand(frame);
+        vp.update();
+        vp.renderDebug(frame, debug);
 
         imshow("Camara Original", frame);
-        imshow("Salida Procesada", vp.outFrame);
+        imshow("Salida Procesada", debug);
         imshow("HSV", vp.hsv);
 
         char key = (char)waitKey(30);
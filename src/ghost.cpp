@@ -0,0 +1,159 @@
+#include "../include/ghost.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+const char MAGIC[4] = { 'G', 'H', 'S', 'T' };
+const float ANGLE_STEPS = 65536.0f / 6.28318531f;   // rumbo: 2^16 pasos por vuelta
+
+void writeVarint(std::vector<uint8_t>& out, int32_t value) {
+    uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);   // zigzag
+    while (v >= 0x80) {
+        out.push_back(uint8_t(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(uint8_t(v));
+}
+
+int32_t readVarint(const std::vector<uint8_t>& in, size_t& pos) {
+    uint32_t v = 0;
+    for (int shift = 0; pos < in.size() && shift < 35; shift += 7) {
+        uint8_t b = in[pos++];
+        v |= uint32_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) break;
+    }
+    return int32_t(v >> 1) ^ -int32_t(v & 1);
+}
+
+template <typename T>
+void writeRaw(std::ofstream& f, const T& v) { f.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+
+template <typename T>
+bool readRaw(std::ifstream& f, T& v) { return (bool)f.read(reinterpret_cast<char*>(&v), sizeof(T)); }
+}
+
+// ========== Archivo ==========
+
+bool GhostTrack::Save(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+
+    f.write(MAGIC, 4);
+    writeRaw(f, VERSION);
+    writeRaw(f, tickRate);
+    writeRaw(f, posStep);
+    writeRaw(f, startOffset);
+    writeRaw(f, lapTime);
+    writeRaw(f, frameCount);
+    writeRaw(f, (uint32_t)keyOffsets.size());
+    writeRaw(f, (uint32_t)data.size());
+    f.write(reinterpret_cast<const char*>(keyOffsets.data()), keyOffsets.size() * sizeof(uint32_t));
+    f.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return (bool)f;
+}
+
+bool GhostTrack::Load(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+
+    char magic[4];
+    uint32_t version = 0, keyCount = 0, dataSize = 0;
+    if (!f.read(magic, 4) || std::memcmp(magic, MAGIC, 4) != 0 || !readRaw(f, version) || version != VERSION) {
+        std::cerr << "Fantasma: formato invalido en " << path << "\n";
+        return false;
+    }
+    readRaw(f, tickRate);
+    readRaw(f, posStep);
+    readRaw(f, startOffset);
+    readRaw(f, lapTime);
+    readRaw(f, frameCount);
+    readRaw(f, keyCount);
+    readRaw(f, dataSize);
+    if (!f || keyCount != (frameCount + KEY_INTERVAL - 1) / KEY_INTERVAL) {
+        std::cerr << "Fantasma: encabezado invalido en " << path << "\n";
+        return false;
+    }
+
+    keyOffsets.resize(keyCount);
+    data.resize(dataSize);
+    f.read(reinterpret_cast<char*>(keyOffsets.data()), keyCount * sizeof(uint32_t));
+    f.read(reinterpret_cast<char*>(data.data()), dataSize);
+    return (bool)f;
+}
+
+// ========== Grabacion ==========
+
+void GhostRecorder::Start(float tickRate, float startOffset) {
+    track = GhostTrack();
+    track.tickRate = tickRate;
+    track.startOffset = startOffset;
+    recording = true;
+}
+
+void GhostRecorder::Add(const glm::vec3& position, float heading) {
+    if (!recording) return;
+
+    const float inv = 1.0f / track.posStep;
+    int32_t q[4] = {
+        (int32_t)std::lround(position.x * inv),
+        (int32_t)std::lround(position.y * inv),
+        (int32_t)std::lround(position.z * inv),
+        (int32_t)std::lround(heading * ANGLE_STEPS),
+    };
+
+    bool key = track.frameCount % GhostTrack::KEY_INTERVAL == 0;
+    if (key) track.keyOffsets.push_back((uint32_t)track.data.size());
+    for (int k = 0; k < 4; k++) {
+        writeVarint(track.data, key ? q[k] : q[k] - prev[k]);
+        prev[k] = q[k];
+    }
+    track.frameCount++;
+}
+
+// ========== Reproduccion ==========
+
+void GhostPlayer::SetTrack(const GhostTrack& t) {
+    track = t;
+    valid = false;
+}
+
+void GhostPlayer::Seek(uint32_t target) {
+    uint32_t key = target / GhostTrack::KEY_INTERVAL;
+    cursor = track.keyOffsets[key];
+    frame = key * GhostTrack::KEY_INTERVAL;
+    for (int k = 0; k < 4; k++) cur[k] = readVarint(track.data, cursor);
+    std::memcpy(prev, cur, sizeof(cur));
+    valid = true;
+}
+
+void GhostPlayer::Next() {
+    std::memcpy(prev, cur, sizeof(cur));
+    frame++;
+    bool key = frame % GhostTrack::KEY_INTERVAL == 0;
+    for (int k = 0; k < 4; k++) {
+        int32_t v = readVarint(track.data, cursor);
+        cur[k] = key ? v : cur[k] + v;
+    }
+}
+
+bool GhostPlayer::Sample(double lapTime, glm::vec3& position, float& heading) {
+    if (Empty()) return false;
+
+    double f = (lapTime - track.startOffset) * track.tickRate;
+    if (f < 0.0 || f >= track.frameCount - 1) return false;
+    uint32_t i = (uint32_t)f;
+
+    // se necesitan los cuadros i (prev) e i + 1 (cur)
+    if (!valid || frame > i + 1 || i >= frame + GhostTrack::KEY_INTERVAL)
+        Seek(i);
+    while (frame < i + 1) Next();
+
+    float t = float(f - i);
+    glm::vec3 a(prev[0], prev[1], prev[2]), b(cur[0], cur[1], cur[2]);
+    position = glm::mix(a, b, t) * track.posStep;
+    heading = (prev[3] + (cur[3] - prev[3]) * t) / ANGLE_STEPS;
+    return true;
+}
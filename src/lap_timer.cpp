@@ -0,0 +1,217 @@
+#include "../include/lap_timer.h"
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+float cross2(const glm::vec2& u, const glm::vec2& v) {
+    return u.x * v.y - u.y * v.x;
+}
+}
+
+bool LapTimer::Load(const std::string& path, const glm::mat4& simFromMarker) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) return false;
+
+    std::vector<CheckpointGate> loaded;
+    cv::FileNode node = fs["gates"];
+    for (cv::FileNodeIterator it = node.begin(); it != node.end(); ++it) {
+        cv::Point2f a, b;
+        int sector = 0;
+        (*it)["a"] >> a;
+        (*it)["b"] >> b;
+        (*it)["sector"] >> sector;
+
+        glm::vec4 sa = simFromMarker * glm::vec4(a.x, a.y, 0.0f, 1.0f);
+        glm::vec4 sb = simFromMarker * glm::vec4(b.x, b.y, 0.0f, 1.0f);
+        CheckpointGate g;
+        g.a = glm::vec2(sa.x, sa.z);
+        g.b = glm::vec2(sb.x, sb.z);
+        g.sector = sector != 0;
+        loaded.push_back(g);
+    }
+    if (loaded.size() < 2) {
+        std::cerr << "LapTimer: se necesitan al menos 2 compuertas en " << path << "\n";
+        return false;
+    }
+
+    SetGates(loaded);
+    std::cout << "Compuertas cargadas de " << path << ": " << gates.size() << "\n";
+    return true;
+}
+
+bool LapTimer::Save(const std::string& path, const glm::mat4& markerFromSim) const {
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened() || gates.empty()) return false;
+
+    fs << "gates" << "[";
+    for (const auto& g : gates) {
+        glm::vec4 a = markerFromSim * glm::vec4(g.a.x, 0.0f, g.a.y, 1.0f);
+        glm::vec4 b = markerFromSim * glm::vec4(g.b.x, 0.0f, g.b.y, 1.0f);
+        fs << "{" << "a" << cv::Point2f(a.x, a.y) << "b" << cv::Point2f(b.x, b.y)
+           << "sector" << (g.sector ? 1 : 0) << "}";
+    }
+    fs << "]";
+    return true;
+}
+
+void LapTimer::GenerateFromLine(const RacingLine& line, int count, int sectorEvery) {
+    if (line.Empty() || count < 2) return;
+
+    int n = (int)line.points.size();
+    float step = 0.5f * line.Spacing();
+    std::vector<CheckpointGate> generated;
+    for (int k = 0; k < count; k++) {
+        int idx = k * n / count;
+        glm::vec2 p = line.points[idx];
+        glm::vec2 f = glm::normalize(line.points[(idx + 1) % n] - p);
+        glm::vec2 side(f.y, -f.x);
+
+        // hasta el borde de la pista a cada lado
+        float left = 0.0f, right = 0.0f;
+        for (int s = 0; s < 400 && line.Distance(p.x + side.x * left, p.y + side.y * left) > 0.0f; s++) left += step;
+        for (int s = 0; s < 400 && line.Distance(p.x - side.x * right, p.y - side.y * right) > 0.0f; s++) right += step;
+
+        CheckpointGate g;
+        g.a = p + side * left;
+        g.b = p - side * right;
+        g.sector = sectorEvery > 0 && k % sectorEvery == 0;
+        generated.push_back(g);
+    }
+    SetGates(generated);
+}
+
+void LapTimer::SetGates(const std::vector<CheckpointGate>& newGates) {
+    gates = newGates;
+    BuildHash();
+    ResetRacers(racers.size());
+}
+
+void LapTimer::ResetRacers(size_t count) {
+    racers.assign(count, Racer());
+}
+
+int LapTimer::Bucket(int cx, int cz) const {
+    unsigned int h = (unsigned int)cx * 73856093u ^ (unsigned int)cz * 19349663u;
+    return (int)(h & (unsigned int)tableMask);
+}
+
+void LapTimer::BuildHash() {
+    bucketStart.clear();
+    bucketItems.clear();
+    if (gates.empty()) return;
+
+    // una compuerta ocupa como mucho 2x2 celdas
+    cellSize = 0.0f;
+    for (const auto& g : gates) cellSize = std::max(cellSize, glm::length(g.b - g.a));
+    cellSize = std::max(cellSize, 1e-3f);
+
+    int tableSize = 64;
+    while (tableSize < (int)gates.size() * 8) tableSize *= 2;
+    tableMask = tableSize - 1;
+
+    // conteo, prefijos y llenado (listas compactas por cubeta)
+    auto forEachCell = [&](const CheckpointGate& g, auto&& fn) {
+        int x0 = (int)std::floor(std::min(g.a.x, g.b.x) / cellSize), x1 = (int)std::floor(std::max(g.a.x, g.b.x) / cellSize);
+        int z0 = (int)std::floor(std::min(g.a.y, g.b.y) / cellSize), z1 = (int)std::floor(std::max(g.a.y, g.b.y) / cellSize);
+        for (int cz = z0; cz <= z1; cz++)
+            for (int cx = x0; cx <= x1; cx++) fn(Bucket(cx, cz));
+    };
+
+    bucketStart.assign(tableSize + 1, 0);
+    for (const auto& g : gates) forEachCell(g, [&](int b) { bucketStart[b + 1]++; });
+    for (int b = 0; b < tableSize; b++) bucketStart[b + 1] += bucketStart[b];
+
+    bucketItems.resize(bucketStart[tableSize]);
+    std::vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (int i = 0; i < (int)gates.size(); i++) forEachCell(gates[i], [&](int b) { bucketItems[fill[b]++] = i; });
+}
+
+bool LapTimer::Update(size_t racer, const glm::vec2& from, const glm::vec2& to, double t0, double t1) {
+    if (gates.empty() || racer >= racers.size()) return false;
+    Racer& r = racers[racer];
+
+    // celdas que toca el movimiento de este tick (normalmente una)
+    glm::vec2 d = to - from;
+    int x0 = (int)std::floor(std::min(from.x, to.x) / cellSize), x1 = (int)std::floor(std::max(from.x, to.x) / cellSize);
+    int z0 = (int)std::floor(std::min(from.y, to.y) / cellSize), z1 = (int)std::floor(std::max(from.y, to.y) / cellSize);
+    if ((x1 - x0 + 1) * (z1 - z0 + 1) > 16) return false;   // salto (reset): no cuenta
+
+    // interseccion de segmentos con cada compuerta de esas celdas
+    crossings.clear();
+    for (int cz = z0; cz <= z1; cz++)
+        for (int cx = x0; cx <= x1; cx++) {
+            int b = Bucket(cx, cz);
+            for (int k = bucketStart[b]; k < bucketStart[b + 1]; k++) {
+                int gi = bucketItems[k];
+                bool seen = false;   // una compuerta puede estar en varias celdas
+                for (const Crossing& c : crossings) seen = seen || c.gate == gi;
+                if (seen) continue;
+
+                const CheckpointGate& g = gates[gi];
+                glm::vec2 s = g.b - g.a;
+                float denom = cross2(d, s);
+                if (std::fabs(denom) <= 1e-12f) continue;
+                glm::vec2 ap = g.a - from;
+                float t = cross2(ap, s) / denom;
+                float u = cross2(ap, d) / denom;
+                if (t < 0.0f || t > 1.0f || u < 0.0f || u > 1.0f) continue;
+                crossings.push_back({ t, gi, denom > 0.0f });
+            }
+        }
+    std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) { return a.t < b.t; });
+
+    const int n = (int)gates.size();
+    bool lapDone = false;
+    for (const Crossing& c : crossings) {
+        if (!c.forward) {
+            r.wrongWay = true;
+            continue;
+        }
+        r.wrongWay = false;
+
+        // distancia hacia adelante desde la siguiente; mas de media vuelta es volver
+        // a cruzar una ya pasada. Antes de la salida solo cuenta la compuerta 0
+        int ahead = (c.gate - r.nextGate + n) % n;
+        if (ahead > n / 2 || (r.lap == 0 && c.gate != 0)) continue;
+
+        double tc = t0 + (t1 - t0) * c.t;
+        for (; ahead > 0; ahead--) {
+            // saltar la salida cierra la vuelta anterior y abre la nueva invalidas
+            bool start = r.nextGate == 0;
+            r.skipped++;
+            lapDone = Cross(r, tc) || lapDone;
+            if (start) r.skipped++;
+        }
+        lapDone = Cross(r, tc) || lapDone;
+    }
+    return lapDone;
+}
+
+bool LapTimer::Cross(Racer& r, double tc) {
+    const CheckpointGate& g = gates[r.nextGate];
+    bool lapDone = false;
+
+    if (r.nextGate == 0) {
+        if (r.lap > 0) {
+            r.sectors.push_back(tc - r.sectorStart);
+            r.lastLap = tc - r.lapStart;
+            r.lastLapValid = r.skipped == 0;
+            if (r.lastLapValid && (r.bestLap < 0.0 || r.lastLap < r.bestLap)) r.bestLap = r.lastLap;
+            r.lastSectors.swap(r.sectors);
+            lapDone = true;
+        }
+        r.sectors.clear();
+        r.skipped = 0;
+        r.lap++;
+        r.lapStart = r.sectorStart = tc;
+    } else if (g.sector) {
+        r.sectors.push_back(tc - r.sectorStart);
+        r.sectorStart = tc;
+    }
+
+    r.nextGate = (r.nextGate + 1) % (int)gates.size();
+    return lapDone;
+}
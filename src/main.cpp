@@ -3,8 +3,13 @@
 #include <opencv2/opencv.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <string>
 
+#include "../include/asset_loader.h"
 #include "../include/model_renderer.h"
 #include "../include/marker_detection.h"
 #include "../include/vision/gesture_recognition.h"
@@ -34,6 +39,51 @@ int main() {
         drawTrack = false;
     }
 
+    std::cout << "¿Usar una sola cámara para el marcador y la mano? (1 = sí, 0 = no): ";
+    int unaCamara = 0;
+    std::cin >> unaCamara;
+    bool singleCamera = (unaCamara == 1);
+
+    std::cout << "¿Cuántos jugadores? (1 o 2, una mano por jugador): ";
+    int numJugadores = 1;
+    std::cin >> numJugadores;
+
+    // linea completa: vacia o invalida deja 60 Hz sin dejar std::cin en error
+    std::cout << "Frecuencia de la simulación en Hz (60 por defecto): ";
+    double tickRate = 60.0;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::string linea;
+    std::getline(std::cin, linea);
+    char* fin = nullptr;
+    double hz = std::strtod(linea.c_str(), &fin);
+    if (fin != linea.c_str() && hz > 0.0) tickRate = hz;
+
+    int numOponentes = 0;
+    if (drawTrack) {
+        std::cout << "¿Cuántos rivales controlados por la computadora? (0 = ninguno): ";
+        std::cin >> numOponentes;
+    }
+
+    // Los modelos se importan y decodifican en segundo plano mientras se crean
+    // la ventana y se abren las camaras; el hilo de OpenGL solo los sube.
+    // Con recursos horneados (tools/asset_baker) se evita Assimp + stb.
+    auto startTime = std::chrono::steady_clock::now();
+    const std::string packPath = "../models/recursos.pack";
+    const std::string carroPath = "../models/carro2/Carro.obj";
+    //const std::string pistaPath = "../models/pista/10605_Slot_Car_Race_Track_v1_L3.obj";
+    const std::string pistaPath = "../models/pista/The Circuit.obj";
+    AssetPack pack;
+    bool usePack = pack.Open(packPath);
+    if (!usePack && AssetPack::IsOutdated(packPath)) {
+        // paquete de una version anterior: se vuelve a hornear una vez con estos modelos
+        std::cout << "Paquete de recursos desactualizado, horneando de nuevo...\n";
+        usePack = WriteAssetPack(packPath, { carroPath, pistaPath }) && pack.Open(packPath);
+        if (!usePack)
+            std::cerr << "No se pudo rehornear " << packPath << ", ejecutar tools/asset_baker. Se usa Assimp + stb\n";
+    }
+    AssetLoader loader;
+    int carroId = loader.Load(carroPath, usePack ? &pack : nullptr);
+    int pistaId = loader.Load(pistaPath, usePack ? &pack : nullptr);
 
     if (!glfwInit()) {
         std::cerr << "Error al inicializar GLFW\n";
@@ -61,38 +111,129 @@ int main() {
     glEnable(GL_DEPTH_TEST);
     initQuad();
 
-    ModelRenderer renderer("../models/carro2/Carro.obj");
-    //ModelRenderer pistaRenderer("../models/pista/10605_Slot_Car_Race_Track_v1_L3.obj");
-    ModelRenderer pistaRenderer("../models/pista/The Circuit.obj");
     glm::mat4 projection = glm::perspective(glm::radians(45.0f),
                             (float)SCR_WIDTH / SCR_HEIGHT, 0.1f, 100.0f);
 
     cv::VideoCapture capMarker(0);
-    cv::VideoCapture capHand(1);
-    if (!capMarker.isOpened() || !capHand.isOpened()) {
+    cv::VideoCapture capHand;
+    if (!singleCamera) capHand.open(1);
+    if (!capMarker.isOpened() || (!singleCamera && !capHand.isOpened())) {
         std::cerr << "No se pudieron abrir las cámaras\n";
         return -1;
     }
 
     VisionProcessor vision;
-    GameController game(renderer, vision, K, dist);
+    const std::string skinLutPath = "../src/skin_lut.yml";
+    vision.skinLut.load(skinLutPath);
+    vision.classifier = loadHandClassifier("../src/hand_classifier.yml");
+
+    // recoger cada malla en cuanto esta lista; las texturas se siguen
+    // decodificando y se recogen en el bucle, frame a frame
+    auto waitStart = std::chrono::steady_clock::now();
+    ModelAsset carroAsset = loader.TakeMesh(carroId);
+    double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    double carroMs = carroAsset.loadMs;
+    ModelRenderer renderer(std::move(carroAsset));
+
+    waitStart = std::chrono::steady_clock::now();
+    ModelAsset pistaAsset = loader.TakeMesh(pistaId);
+    waitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    double pistaMs = pistaAsset.loadMs;
+    ModelRenderer pistaRenderer(std::move(pistaAsset));
+    glFinish();
+    // el paquete queda abierto: las texturas se siguen leyendo del mapeo hasta
+    // que ambos renderers terminan de subirlas
+    std::cout << "Carga de modelos (" << (usePack ? "paquete" : "Assimp + stb") << ", " << loader.Workers()
+              << " hilos): carro " << carroMs << " ms, pista " << pistaMs
+              << " ms, espera del hilo de OpenGL " << waitMs << " ms (solo mallas)\n";
+
+    bool carroTexturas = false, pistaTexturas = false;
+    auto recogerTexturas = [&](int id, ModelRenderer& r, bool& listo) {
+        if (listo) return;
+        std::vector<DecodedImage> imagenes;
+        listo = loader.TakeImages(id, imagenes);
+        r.AddTextures(std::move(imagenes), listo);
+    };
+
+    const std::string samplesPath = "../src/hand_samples.csv";
+    GameController game(renderer, vision, K, dist, numJugadores);
+    game.setTickRate(tickRate);
+    game.setOponentes(numOponentes);
+    if (drawTrack) game.setPista(pistaRenderer, "../src/pista_cache.yml.gz");
+    game.setCheckpoints("../src/checkpoints.yml");
+    game.setFantasma("../src/fantasma.bin");
 
     cv::Mat frameMarker, frameHand;
+    bool calibKeyPrev = false;
+    bool sampleKeyPrev = false;
+    bool primerFrame = false;
 
     while (!glfwWindowShouldClose(window)) {
         capMarker >> frameMarker;
-        capHand   >> frameHand;
+        if (singleCamera) {
+            // mismo cv::Mat para las dos etapas, sin copia
+            frameHand = frameMarker;
+        } else {
+            capHand >> frameHand;
+        }
         if (frameMarker.empty() || frameHand.empty()) break;
 
-        game.process(frameMarker, frameHand);
+        // C: calibrar la piel con la mano en el centro de la camara de mano.
+        // Antes de process y de los textos: con una camara frameHand es frameMarker
+        // y se dibuja encima
+        bool calibKey = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+        if (calibKey && !calibKeyPrev) {
+            cv::Rect roi(frameHand.cols / 3, frameHand.rows / 3, frameHand.cols / 3, frameHand.rows / 3);
+            vision.skinLut.addCalibrationRoi(frameHand, roi);
+            vision.skinLut.build();
+            if (vision.skinLut.save(skinLutPath))
+                std::cout << "Tabla de piel guardada en " << skinLutPath << "\n";
+        }
+        calibKeyPrev = calibKey;
+
+        if (singleCamera) game.process(frameMarker);
+        else game.process(frameMarker, frameHand);
 
         cv::putText(frameMarker, game.getStatusText(), cv::Point(20, 30),
                     cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 255, 0), 2);
 
+        // estadisticas del frame anterior
+        const RenderStats& sc = renderer.GetStats();
+        const RenderStats& sp = pistaRenderer.GetStats();
+        char statsText[160];
+        snprintf(statsText, sizeof(statsText), "Draws: %u  Tris: %zu  Verts: %zu  LOD: %u/%u/%u/%u  Texturas: %u  Subido: %.1f MB",
+                 sc.drawCalls + sp.drawCalls, sc.triangles + sp.triangles, sc.vertices + sp.vertices,
+                 sc.lodDraws[0] + sp.lodDraws[0], sc.lodDraws[1] + sp.lodDraws[1], sc.lodDraws[2] + sp.lodDraws[2],
+                 sc.lodDraws[3] + sp.lodDraws[3], sc.textures + sp.textures,
+                 (sc.uploadBytes + sp.uploadBytes) / (1024.0 * 1024.0));
+        cv::putText(frameMarker, statsText, cv::Point(20, 60),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 255), 1);
+        snprintf(statsText, sizeof(statsText), "Rangos visibles: %u  Descartados: %u",
+                 sc.visible + sp.visible, sc.culled + sp.culled);
+        cv::putText(frameMarker, statsText, cv::Point(20, 80),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 255), 1);
+        size_t pendiente = sc.streamPending + sp.streamPending;
+        unsigned int stalls = sc.stalls + sp.stalls;
+        if (pendiente > 0 || stalls > 0) {
+            snprintf(statsText, sizeof(statsText), "Streaming: %.0f KB/frame (%.2f ms)  Pendiente: %.1f MB  Picos: %u",
+                     (sc.streamBytes + sp.streamBytes) / 1024.0, sc.streamMs + sp.streamMs,
+                     pendiente / (1024.0 * 1024.0), stalls);
+            cv::putText(frameMarker, statsText, cv::Point(20, 100),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 200, 255), 1);
+        }
+
         if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
             game.resetPosition();
         }
 
+        // F / O: guardar los rasgos actuales como muestra de punio / mano abierta
+        bool fistKey = glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS;
+        bool openKey = glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS;
+        if ((fistKey || openKey) && !sampleKeyPrev)
+            appendFeatureCsv(samplesPath, vision.features, fistKey ? 1 : 0);
+        sampleKeyPrev = fistKey || openKey;
+        vision.skinLut.reloadIfChanged();
+
         cv::cvtColor(frameMarker, frameMarker, cv::COLOR_BGR2RGB);
         cv::flip(frameMarker, frameMarker, 0);
         glBindTexture(GL_TEXTURE_2D, quadTex);
@@ -103,6 +244,11 @@ int main() {
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        recogerTexturas(carroId, renderer, carroTexturas);
+        recogerTexturas(pistaId, pistaRenderer, pistaTexturas);
+        renderer.BeginFrame();
+        pistaRenderer.BeginFrame();
+
         glDisable(GL_DEPTH_TEST);
         glUseProgram(quadShader);
         glBindVertexArray(quadVAO);
@@ -117,10 +263,16 @@ int main() {
 
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        if (!primerFrame) {
+            primerFrame = true;
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            std::cout << "Primer frame a los " << ms << " ms\n";
+        }
     }
 
     capMarker.release();
-    capHand.release();
+    if (capHand.isOpened()) capHand.release();
     glfwTerminate();
     return 0;
 }
@@ -172,8 +172,14 @@ bool obtenerPoseDelMarcador(
 
 
 void procesarFrame(cv::Mat& frame, const cv::Mat& cameraMatrix, const cv::Mat& distCoeffs, PoseData& poseData) {
-    cv::Mat gray, blurred, bin;
+    cv::Mat gray;
     cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    procesarFrame(frame, gray, cameraMatrix, distCoeffs, poseData);
+}
+
+void procesarFrame(cv::Mat& frame, const cv::Mat& gray, const cv::Mat& cameraMatrix, const cv::Mat& distCoeffs,
+                   PoseData& poseData) {
+    cv::Mat blurred, bin;
     cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 1.5);
     cv::threshold(blurred, bin, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
 
@@ -198,11 +204,9 @@ void procesarFrame(cv::Mat& frame, const cv::Mat& cameraMatrix, const cv::Mat& d
             };
 
             cv::Mat H = cv::findHomography(orderedPts, dstPts);
-            cv::Mat warped;
-            cv::warpPerspective(frame, warped, H, cv::Size(warpSize, warpSize));
-
+            // se rectifica el gris ya calculado, sin otra conversion de color
             cv::Mat warpGray, warpBin;
-            cv::cvtColor(warped, warpGray, cv::COLOR_BGR2GRAY);
+            cv::warpPerspective(gray, warpGray, H, cv::Size(warpSize, warpSize));
             cv::threshold(warpGray, warpBin, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
 
             if (!validarBordeNegro(warpBin)) continue;
@@ -214,6 +218,7 @@ void procesarFrame(cv::Mat& frame, const cv::Mat& cameraMatrix, const cv::Mat& d
 
             if (obtenerPoseDelMarcador(orderedPts, cameraMatrix, distCoeffs, poseData.rvec, poseData.tvec)) {
                 poseData.poseValida = true;
+                poseData.esquinas = orderedPts;
                 std::cout << "Pose del marcador:\n" << "Rotacion: " << poseData.rvec.t() << "\n" << "Traslacion: " << poseData.tvec.t() << "\n";
 
                 std::vector<cv::Point3f> axis = {
@@ -0,0 +1,126 @@
+#include "../include/mesh_data.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+void NormalizeModel(std::vector<float>& verts) {
+    if (verts.empty()) return;
+
+    float minX = verts[0], maxX = verts[0];
+    float minY = verts[1], maxY = verts[1];
+    float minZ = verts[2], maxZ = verts[2];
+
+    for (size_t i = 0; i < verts.size(); i += 5) {
+        float x = verts[i];
+        float y = verts[i + 1];
+        float z = verts[i + 2];
+
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+        minZ = std::min(minZ, z); maxZ = std::max(maxZ, z);
+    }
+
+    float centerX = (minX + maxX) / 2.0f;
+    float centerY = (minY + maxY) / 2.0f;
+    float centerZ = (minZ + maxZ) / 2.0f;
+
+    float sizeX = maxX - minX;
+    float sizeY = maxY - minY;
+    float sizeZ = maxZ - minZ;
+    float maxSize = std::max({sizeX, sizeY, sizeZ});
+    float scale = 2.0f / maxSize;
+
+    for (size_t i = 0; i < verts.size(); i += 5) {
+        verts[i]     = (verts[i]     - centerX) * scale;
+        verts[i + 1] = (verts[i + 1] - centerY) * scale;
+        verts[i + 2] = (verts[i + 2] - centerZ) * scale;
+    }
+}
+
+std::string ResolveTexturePath(const std::string& dir, const std::string& ref) {
+    // el .mtl puede traer rutas absolutas de otra maquina: si no existe, se busca
+    // el mismo archivo junto al modelo
+    std::filesystem::path p = std::filesystem::path(dir) / ref;
+    std::error_code ec;
+    if (!std::filesystem::exists(p, ec))
+        p = std::filesystem::path(dir) / std::filesystem::path(ref).filename();
+    return p.lexically_normal().generic_string();
+}
+
+bool LoadMeshData(const std::string& path, MeshData& out) {
+    Assimp::Importer importer;
+    // PreTransformVertices aplica las transformaciones de los nodos a cada malla
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs |
+                                                   aiProcess_PreTransformVertices);
+
+    std::cout << "Cargando modelo: " << path << std::endl;
+
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
+        return false;
+    }
+
+    // vertices de todas las mallas, uno tras otro
+    std::vector<unsigned int> baseVertex(scene->mNumMeshes);
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        baseVertex[m] = (unsigned int)out.VertexCount();
+
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            aiVector3D pos = mesh->mVertices[i];
+            aiVector3D tex = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0][i] : aiVector3D(0.0f);
+
+            out.vertices.push_back(pos.x);
+            out.vertices.push_back(pos.y);
+            out.vertices.push_back(pos.z);
+            out.vertices.push_back(tex.x);
+            out.vertices.push_back(tex.y);
+        }
+    }
+
+    NormalizeModel(out.vertices);
+
+    // indices agrupados por material: un rango contiguo por material
+    for (unsigned int mat = 0; mat < scene->mNumMaterials; ++mat) {
+        DrawRange range = { mat, (unsigned int)out.indices.size(), 0 };
+        for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+            const aiMesh* mesh = scene->mMeshes[m];
+            if (mesh->mMaterialIndex != mat) continue;
+
+            for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+                const aiFace& face = mesh->mFaces[i];
+                if (face.mNumIndices != 3) continue;   // puntos y lineas sueltos
+                for (unsigned int j = 0; j < 3; ++j)
+                    out.indices.push_back(baseVertex[m] + face.mIndices[j]);
+            }
+        }
+        range.indexCount = (unsigned int)out.indices.size() - range.indexOffset;
+        if (range.indexCount > 0) out.ranges.push_back(range);
+    }
+
+    std::string dir = path.substr(0, path.find_last_of("/\\"));
+    out.materials.resize(scene->mNumMaterials);
+    for (unsigned int mat = 0; mat < scene->mNumMaterials; ++mat) {
+        aiMaterial* material = scene->mMaterials[mat];
+        MeshMaterial& info = out.materials[mat];
+        if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
+            aiString str;
+            material->GetTexture(aiTextureType_DIFFUSE, 0, &str);
+            info.texturePath = ResolveTexturePath(dir, str.C_Str());
+        }
+        aiColor3D kd(1.0f, 1.0f, 1.0f);
+        material->Get(AI_MATKEY_COLOR_DIFFUSE, kd);
+        info.diffuse[0] = kd.r;
+        info.diffuse[1] = kd.g;
+        info.diffuse[2] = kd.b;
+    }
+
+    std::cout << "Vertices cargados: " << out.VertexCount() << ", Triangulos: " << out.TriangleCount()
+              << ", Mallas: " << scene->mNumMeshes << ", Materiales: " << out.ranges.size() << std::endl;
+    return true;
+}
@@ -0,0 +1,127 @@
+#include "../include/mesh_lod.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include "../include/mesh_optimizer.h"
+
+namespace {
+struct Cluster {
+    float sum[MeshData::VERTEX_STRIDE] = {};
+    int count = 0;
+    int cell = 0;   // celda de la grilla; la posicion sale de ahi
+};
+
+uint64_t cellKey(int x, int y, int z) {
+    return ((uint64_t)(x & 0x1FFFFF) << 42) | ((uint64_t)(y & 0x1FFFFF) << 21) | (uint64_t)(z & 0x1FFFFF);
+}
+
+struct TriKeyHash {
+    size_t operator()(const std::array<unsigned int, 3>& t) const {
+        return (size_t)t[0] * 73856093u ^ (size_t)t[1] * 19349663u ^ (size_t)t[2] * 83492791u;
+    }
+};
+}
+
+void SimplifyMesh(const MeshData& mesh, int gridCells, MeshData& out) {
+    const int S = MeshData::VERTEX_STRIDE;
+    out = MeshData();
+    out.materials = mesh.materials;
+    if (mesh.vertices.empty()) return;
+
+    float lo[3], hi[3];
+    for (int c = 0; c < 3; c++) lo[c] = hi[c] = mesh.vertices[c];
+    for (size_t v = 0; v < mesh.VertexCount(); v++)
+        for (int c = 0; c < 3; c++) {
+            lo[c] = std::min(lo[c], mesh.vertices[v * S + c]);
+            hi[c] = std::max(hi[c], mesh.vertices[v * S + c]);
+        }
+    float extent = std::max({ hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2] });
+    float cell = extent > 0 ? extent / gridCells : 1.0f;
+
+    // Posicion: una por celda para toda la malla. SplitRanges parte una misma
+    // superficie en varios rangos y sus vertices de borde deben caer en el mismo
+    // punto, si no cada nivel abre grietas entre rangos
+    std::vector<int> cellOf(mesh.VertexCount(), -1);
+    std::vector<Cluster> cells;
+    std::unordered_map<uint64_t, int> byCell;
+    for (unsigned int v : mesh.indices) {
+        if (cellOf[v] >= 0) continue;
+        const float* p = &mesh.vertices[(size_t)v * S];
+        int x = (int)((p[0] - lo[0]) / cell), y = (int)((p[1] - lo[1]) / cell), z = (int)((p[2] - lo[2]) / cell);
+        auto it = byCell.emplace(cellKey(x, y, z), (int)cells.size());
+        if (it.second) cells.emplace_back();
+        cellOf[v] = it.first->second;
+        Cluster& c = cells[cellOf[v]];
+        for (int k = 0; k < 3; k++) c.sum[k] += p[k];
+        c.count++;
+    }
+
+    // uv: por celda y material, para no mezclar texturas
+    std::vector<int> clusterOf(mesh.VertexCount()), summedIn(mesh.VertexCount(), -1);
+    std::vector<Cluster> clusters;
+    std::unordered_map<int, int> byRangeCell;
+    std::unordered_set<std::array<unsigned int, 3>, TriKeyHash> seen;
+
+    for (size_t r = 0; r < mesh.ranges.size(); r++) {
+        const DrawRange& range = mesh.ranges[r];
+        byRangeCell.clear();
+        seen.clear();
+        const unsigned int* idx = mesh.indices.data() + range.indexOffset;
+
+        // cada vertice una vez, aunque lo usen varios triangulos
+        for (unsigned int i = 0; i < range.indexCount; i++) {
+            unsigned int v = idx[i];
+            if (summedIn[v] == (int)r) continue;
+            summedIn[v] = (int)r;
+            auto it = byRangeCell.emplace(cellOf[v], (int)clusters.size());
+            if (it.second) {
+                clusters.emplace_back();
+                clusters.back().cell = cellOf[v];
+            }
+            clusterOf[v] = it.first->second;
+            Cluster& c = clusters[clusterOf[v]];
+            for (int k = 3; k < S; k++) c.sum[k] += mesh.vertices[(size_t)v * S + k];
+            c.count++;
+        }
+
+        DrawRange outRange = { range.material, (unsigned int)out.indices.size(), 0 };
+        for (unsigned int t = 0; t + 2 < range.indexCount; t += 3) {
+            std::array<unsigned int, 3> tri = { (unsigned int)clusterOf[idx[t]], (unsigned int)clusterOf[idx[t + 1]],
+                                                (unsigned int)clusterOf[idx[t + 2]] };
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) continue;
+            // misma orientacion, distinto vertice inicial: mismo triangulo
+            std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+            if (!seen.insert(tri).second) continue;
+            out.indices.insert(out.indices.end(), tri.begin(), tri.end());
+        }
+        outRange.indexCount = (unsigned int)out.indices.size() - outRange.indexOffset;
+        out.ranges.push_back(outRange);
+    }
+
+    out.vertices.resize(clusters.size() * S);
+    for (size_t i = 0; i < clusters.size(); i++) {
+        const Cluster& c = clusters[i];
+        const Cluster& pos = cells[c.cell];
+        float* dst = &out.vertices[i * S];
+        for (int k = 0; k < 3; k++) dst[k] = pos.sum[k] / pos.count;
+        for (int k = 3; k < S; k++) dst[k] = c.sum[k] / c.count;
+    }
+}
+
+void BuildLods(const MeshData& mesh, std::vector<MeshData>& lods) {
+    lods.clear();
+    size_t previous = mesh.TriangleCount();
+    for (int grid = MeshLod::FIRST_GRID; (int)lods.size() + 1 < MeshLod::MAX_LODS && grid >= 2; grid /= 2) {
+        MeshData lod;
+        SimplifyMesh(mesh, grid, lod);
+        if (lod.TriangleCount() == 0 || lod.TriangleCount() > previous * MeshLod::MIN_REDUCTION) continue;
+        OptimizeVertexCache(lod);
+        OptimizeVertexFetch(lod);
+        previous = lod.TriangleCount();
+        lods.push_back(std::move(lod));
+    }
+}
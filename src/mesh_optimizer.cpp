@@ -0,0 +1,382 @@
+#include "../include/mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+namespace {
+// ========== Forsyth, "Linear-Speed Vertex Cache Optimisation" ==========
+
+const int CACHE_SIZE = 32;
+
+float vertexScore(int cachePos, int valence) {
+    if (valence == 0) return -1.0f;   // ya no lo usa ningun triangulo pendiente
+    float score = 0.0f;
+    if (cachePos >= 0) {
+        // los 3 del ultimo triangulo valen fijo, para no favorecer tiras largas
+        if (cachePos < 3) score = 0.75f;
+        else score = std::pow(1.0f - (cachePos - 3) / float(CACHE_SIZE - 3), 1.5f);
+    }
+    // priorizar vertices con pocos triangulos pendientes
+    return score + 2.0f * std::pow((float)valence, -0.5f);
+}
+
+// Reordena triCount triangulos de indices locales [0, vertexCount)
+void forsythRange(const unsigned int* in, size_t triCount, size_t vertexCount, unsigned int* out) {
+    // triangulos de cada vertice (CSR); adjCount baja al emitir
+    std::vector<int> adjStart(vertexCount + 1, 0), adjCount(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; i++) adjStart[in[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++) adjStart[v + 1] += adjStart[v];
+    std::vector<int> adj(triCount * 3);
+    for (size_t t = 0; t < triCount; t++)
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = in[t * 3 + k];
+            adj[adjStart[v] + adjCount[v]++] = (int)t;
+        }
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) vScore[v] = vertexScore(-1, adjCount[v]);
+    std::vector<float> tScore(triCount);
+    std::vector<bool> emitted(triCount, false);
+    for (size_t t = 0; t < triCount; t++)
+        tScore[t] = vScore[in[t * 3]] + vScore[in[t * 3 + 1]] + vScore[in[t * 3 + 2]];
+
+    std::vector<unsigned int> cache, next;
+    cache.reserve(CACHE_SIZE + 3);
+    next.reserve(CACHE_SIZE + 3);
+    int best = (int)(std::max_element(tScore.begin(), tScore.end()) - tScore.begin());
+    size_t scan = 0;
+
+    for (size_t n = 0; n < triCount; n++) {
+        // sin candidatos en la cache: el mejor de los que quedan
+        if (best < 0) {
+            float bestScore = -1e30f;
+            while (scan < triCount && emitted[scan]) scan++;
+            for (size_t t = scan; t < triCount; t++)
+                if (!emitted[t] && tScore[t] > bestScore) {
+                    bestScore = tScore[t];
+                    best = (int)t;
+                }
+        }
+
+        const unsigned int* tri = in + (size_t)best * 3;
+        std::copy(tri, tri + 3, out + n * 3);
+        emitted[best] = true;
+
+        // quitar el triangulo de la lista de sus vertices
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = tri[k];
+            int* list = &adj[adjStart[v]];
+            int count = adjCount[v];
+            for (int i = 0; i < count; i++)
+                if (list[i] == best) {
+                    list[i] = list[count - 1];
+                    break;
+                }
+            adjCount[v]--;
+        }
+
+        // LRU: los del triangulo adelante, el resto corre
+        next.assign(tri, tri + 3);
+        for (unsigned int v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2]) next.push_back(v);
+        for (size_t i = 0; i < next.size(); i++) {
+            unsigned int v = next[i];
+            cachePos[v] = i < (size_t)CACHE_SIZE ? (int)i : -1;
+            vScore[v] = vertexScore(cachePos[v], adjCount[v]);
+        }
+
+        // rescatar solo los triangulos tocados por la cache
+        best = -1;
+        float bestScore = -1e30f;
+        for (unsigned int v : next)
+            for (int i = 0; i < adjCount[v]; i++) {
+                int t = adj[adjStart[v] + i];
+                const unsigned int* tv = in + (size_t)t * 3;
+                tScore[t] = vScore[tv[0]] + vScore[tv[1]] + vScore[tv[2]];
+                if (tScore[t] > bestScore) {
+                    bestScore = tScore[t];
+                    best = t;
+                }
+            }
+
+        if (next.size() > (size_t)CACHE_SIZE) next.resize(CACHE_SIZE);
+        std::swap(cache, next);
+    }
+}
+
+struct VertexKey {
+    std::array<uint32_t, MeshData::VERTEX_STRIDE> bits;
+    bool operator==(const VertexKey& o) const { return bits == o.bits; }
+};
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& k) const {
+        uint64_t h = 14695981039346656037ull;
+        for (uint32_t b : k.bits) {
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+        return (size_t)h;
+    }
+};
+
+int16_t quantizeSnorm(float v) {
+    return (int16_t)std::lround(std::max(-1.0f, std::min(1.0f, v)) * 32767.0f);
+}
+uint16_t quantizeUnorm(float v) {
+    return (uint16_t)std::lround(std::max(0.0f, std::min(1.0f, v)) * 65535.0f);
+}
+}
+
+// ========== Soldado y orden ==========
+
+void WeldVertices(MeshData& mesh) {
+    const int S = MeshData::VERTEX_STRIDE;
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> unique;
+    unique.reserve(mesh.VertexCount());
+    std::vector<unsigned int> remap(mesh.VertexCount());
+    std::vector<float> welded;
+    welded.reserve(mesh.vertices.size());
+
+    for (size_t v = 0; v < mesh.VertexCount(); v++) {
+        VertexKey key;
+        // -0 y 0 son el mismo vertice
+        for (int c = 0; c < S; c++) {
+            float f = mesh.vertices[v * S + c] + 0.0f;
+            std::memcpy(&key.bits[c], &f, sizeof(float));
+        }
+        auto it = unique.emplace(key, (unsigned int)(welded.size() / S));
+        if (it.second) welded.insert(welded.end(), mesh.vertices.begin() + v * S, mesh.vertices.begin() + (v + 1) * S);
+        remap[v] = it.first->second;
+    }
+
+    for (unsigned int& i : mesh.indices) i = remap[i];
+    mesh.vertices.swap(welded);
+}
+
+void SplitRanges(MeshData& mesh, int cells) {
+    const int S = MeshData::VERTEX_STRIDE;
+    if (mesh.vertices.empty()) return;
+
+    float lo[3], hi[3];
+    for (int c = 0; c < 3; c++) lo[c] = hi[c] = mesh.vertices[c];
+    for (size_t v = 0; v < mesh.VertexCount(); v++)
+        for (int c = 0; c < 3; c++) {
+            lo[c] = std::min(lo[c], mesh.vertices[v * S + c]);
+            hi[c] = std::max(hi[c], mesh.vertices[v * S + c]);
+        }
+    float extent = std::max({ hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2] });
+    float size = extent > 0 ? extent / cells : 1.0f;
+    int n[3];
+    for (int c = 0; c < 3; c++) n[c] = std::max(1, (int)std::ceil((hi[c] - lo[c]) / size));
+
+    std::vector<unsigned int> indices;
+    std::vector<DrawRange> ranges;
+    indices.reserve(mesh.indices.size());
+    std::vector<int> cellOf;
+    std::vector<unsigned int> start;
+
+    for (const DrawRange& range : mesh.ranges) {
+        const unsigned int* idx = mesh.indices.data() + range.indexOffset;
+        unsigned int triCount = range.indexCount / 3;
+        if (triCount < (unsigned int)SPLIT_MIN_TRIANGLES) {
+            ranges.push_back({ range.material, (unsigned int)indices.size(), range.indexCount });
+            indices.insert(indices.end(), idx, idx + range.indexCount);
+            continue;
+        }
+
+        // celda del centroide de cada triangulo, y orden estable por celda
+        int cellCount = n[0] * n[1] * n[2];
+        cellOf.resize(triCount);
+        start.assign(cellCount + 1, 0);
+        for (unsigned int t = 0; t < triCount; t++) {
+            int cell[3];
+            for (int c = 0; c < 3; c++) {
+                float centroid = (mesh.vertices[(size_t)idx[t * 3] * S + c] + mesh.vertices[(size_t)idx[t * 3 + 1] * S + c] +
+                                  mesh.vertices[(size_t)idx[t * 3 + 2] * S + c]) / 3.0f;
+                cell[c] = std::min(n[c] - 1, std::max(0, (int)((centroid - lo[c]) / size)));
+            }
+            cellOf[t] = (cell[2] * n[1] + cell[1]) * n[0] + cell[0];
+            start[cellOf[t] + 1]++;
+        }
+        for (int c = 0; c < cellCount; c++) start[c + 1] += start[c];
+
+        size_t base = indices.size();
+        indices.resize(base + range.indexCount);
+        std::vector<unsigned int> cursor(start.begin(), start.end() - 1);
+        for (unsigned int t = 0; t < triCount; t++) {
+            unsigned int dst = cursor[cellOf[t]]++;
+            std::copy(idx + t * 3, idx + t * 3 + 3, indices.begin() + base + dst * 3);
+        }
+        for (int c = 0; c < cellCount; c++)
+            if (start[c + 1] > start[c])
+                ranges.push_back({ range.material, (unsigned int)(base + start[c] * 3), (start[c + 1] - start[c]) * 3 });
+    }
+
+    mesh.indices.swap(indices);
+    mesh.ranges.swap(ranges);
+}
+
+void OptimizeVertexCache(MeshData& mesh) {
+    std::vector<unsigned int> local, out;
+    std::vector<int> toLocal(mesh.VertexCount(), -1);
+    std::vector<unsigned int> toGlobal;
+
+    for (const DrawRange& range : mesh.ranges) {
+        unsigned int* idx = mesh.indices.data() + range.indexOffset;
+
+        // indices locales al rango, para que el costo no dependa del resto
+        local.resize(range.indexCount);
+        toGlobal.clear();
+        for (unsigned int i = 0; i < range.indexCount; i++) {
+            unsigned int v = idx[i];
+            if (toLocal[v] < 0) {
+                toLocal[v] = (int)toGlobal.size();
+                toGlobal.push_back(v);
+            }
+            local[i] = (unsigned int)toLocal[v];
+        }
+
+        out.resize(range.indexCount);
+        forsythRange(local.data(), range.indexCount / 3, toGlobal.size(), out.data());
+        for (unsigned int i = 0; i < range.indexCount; i++) idx[i] = toGlobal[out[i]];
+        for (unsigned int v : toGlobal) toLocal[v] = -1;
+    }
+}
+
+void OptimizeVertexFetch(MeshData& mesh) {
+    const int S = MeshData::VERTEX_STRIDE;
+    std::vector<int> remap(mesh.VertexCount(), -1);
+    std::vector<float> ordered;
+    ordered.reserve(mesh.vertices.size());
+
+    // por orden de primer uso; los vertices sin indices se descartan
+    for (unsigned int& i : mesh.indices) {
+        if (remap[i] < 0) {
+            remap[i] = (int)(ordered.size() / S);
+            ordered.insert(ordered.end(), mesh.vertices.begin() + (size_t)i * S, mesh.vertices.begin() + ((size_t)i + 1) * S);
+        }
+        i = (unsigned int)remap[i];
+    }
+    mesh.vertices.swap(ordered);
+}
+
+double ComputeACMR(const MeshData& mesh, int cacheSize) {
+    if (mesh.indices.empty()) return 0.0;
+    std::vector<bool> inCache(mesh.VertexCount(), false);
+    std::deque<unsigned int> fifo;
+    size_t misses = 0;
+    for (unsigned int v : mesh.indices) {
+        if (inCache[v]) continue;
+        misses++;
+        fifo.push_back(v);
+        inCache[v] = true;
+        if ((int)fifo.size() > cacheSize) {
+            inCache[fifo.front()] = false;
+            fifo.pop_front();
+        }
+    }
+    return (double)misses / mesh.TriangleCount();
+}
+
+MeshOptStats OptimizeMesh(MeshData& mesh) {
+    MeshOptStats stats;
+    stats.verticesBefore = mesh.VertexCount();
+    stats.acmrBefore = ComputeACMR(mesh);
+    stats.bytesBefore = FloatMeshBytes(mesh);
+
+    WeldVertices(mesh);
+    SplitRanges(mesh);
+    OptimizeVertexCache(mesh);
+    OptimizeVertexFetch(mesh);
+
+    stats.verticesAfter = mesh.VertexCount();
+    stats.acmrAfter = ComputeACMR(mesh);
+    return stats;
+}
+
+// ========== Formato compacto ==========
+
+size_t FloatMeshBytes(const MeshData& mesh) {
+    return mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int);
+}
+
+void BuildGpuMesh(const MeshData& mesh, GpuMesh& out) {
+    const int S = MeshData::VERTEX_STRIDE;
+    size_t n = mesh.VertexCount();
+    out = GpuMesh();
+    if (n == 0) return;
+
+    // rango de cada componente
+    float lo[5], hi[5];
+    for (int c = 0; c < S; c++) lo[c] = hi[c] = mesh.vertices[c];
+    for (size_t v = 0; v < n; v++)
+        for (int c = 0; c < S; c++) {
+            lo[c] = std::min(lo[c], mesh.vertices[v * S + c]);
+            hi[c] = std::max(hi[c], mesh.vertices[v * S + c]);
+        }
+    for (int c = 0; c < 3; c++) {
+        out.posOffset[c] = 0.5f * (lo[c] + hi[c]);
+        out.posScale[c] = hi[c] > lo[c] ? 0.5f * (hi[c] - lo[c]) : 1.0f;
+    }
+    for (int c = 0; c < 2; c++) {
+        out.uvOffset[c] = lo[3 + c];
+        out.uvScale[c] = hi[3 + c] > lo[3 + c] ? hi[3 + c] - lo[3 + c] : 1.0f;
+    }
+
+    out.vertexCount = n;
+    out.vertices.resize(n);
+    for (size_t v = 0; v < n; v++) {
+        const float* src = &mesh.vertices[v * S];
+        PackedVertex& dst = out.vertices[v];
+        for (int c = 0; c < 3; c++) dst.position[c] = quantizeSnorm((src[c] - out.posOffset[c]) / out.posScale[c]);
+        dst.pad = 0;
+        for (int c = 0; c < 2; c++) dst.uv[c] = quantizeUnorm((src[3 + c] - out.uvOffset[c]) / out.uvScale[c]);
+    }
+
+    // 16 bits relativos al menor vertice del rango cuando caben
+    for (const DrawRange& range : mesh.ranges) {
+        if (range.indexCount == 0) continue;
+        const unsigned int* idx = mesh.indices.data() + range.indexOffset;
+        unsigned int minV = idx[0], maxV = idx[0];
+        for (unsigned int i = 0; i < range.indexCount; i++) {
+            minV = std::min(minV, idx[i]);
+            maxV = std::max(maxV, idx[i]);
+        }
+
+        GpuDrawRange r;
+        for (int c = 0; c < 3; c++) {
+            r.boundsMin[c] = mesh.vertices[(size_t)idx[0] * S + c];
+            r.boundsMax[c] = r.boundsMin[c];
+        }
+        for (unsigned int i = 0; i < range.indexCount; i++)
+            for (int c = 0; c < 3; c++) {
+                float p = mesh.vertices[(size_t)idx[i] * S + c];
+                r.boundsMin[c] = std::min(r.boundsMin[c], p);
+                r.boundsMax[c] = std::max(r.boundsMax[c], p);
+            }
+        r.material = range.material;
+        r.indexCount = range.indexCount;
+        r.shortIndices = maxV - minV <= 0xFFFF;
+        r.vertexSpan = maxV - minV + 1;
+        r.baseVertex = r.shortIndices ? (int)minV : 0;
+        r.byteOffset = (out.indexData.size() + 3) & ~size_t(3);
+        size_t bytes = range.indexCount * (r.shortIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+        out.indexData.resize(r.byteOffset + bytes);
+
+        unsigned char* dst = out.indexData.data() + r.byteOffset;
+        for (unsigned int i = 0; i < range.indexCount; i++) {
+            if (r.shortIndices) {
+                uint16_t s = (uint16_t)(idx[i] - minV);
+                std::memcpy(dst + i * sizeof(s), &s, sizeof(s));
+            } else {
+                std::memcpy(dst + i * sizeof(uint32_t), &idx[i], sizeof(uint32_t));
+            }
+        }
+        out.ranges.push_back(r);
+    }
+}
@@ -1,10 +1,10 @@
 #include "../include/model_renderer.h"
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -19,12 +19,13 @@ layout (location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
+uniform mat4 model;        // incluye la decuantizacion de la posicion
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec4 uvTransform;  // offset (xy) y escala (zw) de las uv cuantizadas
 
 void main() {
-    TexCoord = aTexCoord;
+    TexCoord = uvTransform.xy + aTexCoord * uvTransform.zw;
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
 )glsl";
@@ -34,12 +35,26 @@ const char* fragmentShaderSource = R"glsl(
 in vec2 TexCoord;
 out vec4 FragColor;
 
-uniform sampler2D texture_diffuse1;
+// un arreglo de texturas por tamanio (ver TextureManager)
+uniform sampler2DArray textureArray0;
+uniform sampler2DArray textureArray1;
+uniform sampler2DArray textureArray2;
+uniform sampler2DArray textureArray3;
+uniform int textureArray;     // -1: color difuso
+uniform float textureLayer;
+uniform vec3 diffuseColor;
+uniform float alpha;
 
 void main() {
-    vec4 texColor = texture(texture_diffuse1, TexCoord);
+    vec3 uvw = vec3(TexCoord, textureLayer);
+    vec4 texColor;
+    if (textureArray == 0)      texColor = texture(textureArray0, uvw);
+    else if (textureArray == 1) texColor = texture(textureArray1, uvw);
+    else if (textureArray == 2) texColor = texture(textureArray2, uvw);
+    else if (textureArray == 3) texColor = texture(textureArray3, uvw);
+    else                        texColor = vec4(diffuseColor, 1.0);
     if (texColor.a == 0.0) texColor = vec4(1.0, 0.2, 0.2, 1.0);  // rojo si no hay
-    FragColor = texColor;
+    FragColor = vec4(texColor.rgb, texColor.a * alpha);
 }
 )glsl";
 
@@ -175,8 +190,11 @@ void DrawBackground() {
     glBindVertexArray(0);
 }
 
-ModelRenderer::ModelRenderer(const std::string& path) {
-    LoadModel(path);
+ModelRenderer::ModelRenderer(const std::string& path, const AssetPack* pack)
+    : ModelRenderer(LoadModelAsset(path, pack)) {}
+
+ModelRenderer::ModelRenderer(ModelAsset&& asset) {
+    UploadAsset(std::move(asset));
 
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
@@ -194,6 +212,13 @@ ModelRenderer::ModelRenderer(const std::string& path) {
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
+    // arreglo de texturas i en la unidad i
+    glUseProgram(shaderProgram);
+    for (int i = 0; i < TextureManager::MAX_ARRAYS; i++) {
+        std::string name = "textureArray" + std::to_string(i);
+        glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), i);
+    }
+
     SetupMesh();
     SetupBackgroundQuad();
     InitBackgroundShader();
@@ -203,131 +228,96 @@ ModelRenderer::ModelRenderer(const std::string& path) {
     projectionMatrix = glm::mat4(1.0f);
 }
 
-void NormalizeModel(std::vector<float>& verts) {
-    if (verts.empty()) return;
-
-    float minX = verts[0], maxX = verts[0];
-    float minY = verts[1], maxY = verts[1];
-    float minZ = verts[2], maxZ = verts[2];
-
-    for (size_t i = 0; i < verts.size(); i += 5) {
-        float x = verts[i];
-        float y = verts[i + 1];
-        float z = verts[i + 2];
-
-        minX = std::min(minX, x); maxX = std::max(maxX, x);
-        minY = std::min(minY, y); maxY = std::max(maxY, y);
-        minZ = std::min(minZ, z); maxZ = std::max(maxZ, z);
-    }
-
-    float centerX = (minX + maxX) / 2.0f;
-    float centerY = (minY + maxY) / 2.0f;
-    float centerZ = (minZ + maxZ) / 2.0f;
-
-    float sizeX = maxX - minX;
-    float sizeY = maxY - minY;
-    float sizeZ = maxZ - minZ;
-    float maxSize = std::max({sizeX, sizeY, sizeZ});
-    float scale = 2.0f / maxSize;
-
-    for (size_t i = 0; i < verts.size(); i += 5) {
-        verts[i]     = (verts[i]     - centerX) * scale;
-        verts[i + 1] = (verts[i + 1] - centerY) * scale;
-        verts[i + 2] = (verts[i + 2] - centerZ) * scale;
-    }
-}
-
-
-void ModelRenderer::LoadModel(const std::string& path) {
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
-
-    std::cout << "Cargando modelo: " << path << std::endl;
-
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
-        return;
+void ModelRenderer::UploadAsset(ModelAsset&& asset) {
+    if (!asset.ok) return;
+    mesh = std::move(asset.mesh);
+    lods.resize(asset.gpuLods.size());
+    for (size_t i = 0; i < lods.size(); i++) lods[i].mesh = std::move(asset.gpuLods[i]);
+
+    // esfera envolvente para el tamanio en pantalla
+    glm::vec3 lo(0.0f), hi(0.0f);
+    for (size_t v = 0; v < mesh.VertexCount(); v++) {
+        glm::vec3 p = glm::make_vec3(&mesh.vertices[v * MeshData::VERTEX_STRIDE]);
+        lo = v == 0 ? p : glm::min(lo, p);
+        hi = v == 0 ? p : glm::max(hi, p);
     }
-
-    aiMesh* mesh = scene->mMeshes[0];
-
-    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-        aiVector3D pos = mesh->mVertices[i];
-        aiVector3D tex = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0][i] : aiVector3D(0.0f);
-
-        vertices.push_back(pos.x);
-        vertices.push_back(pos.y);
-        vertices.push_back(pos.z);
-        vertices.push_back(tex.x);
-        vertices.push_back(tex.y);
+    boundsCenter = 0.5f * (lo + hi);
+    boundsRadius = 0.5f * glm::length(hi - lo);
+
+    const MeshOptStats& ms = asset.meshStats;
+    std::cout << "Malla " << asset.path << (asset.meshOptimized ? "" : " (horneada)") << ": "
+              << ms.verticesBefore << " -> " << ms.verticesAfter << " vertices, ACMR " << ms.acmrBefore << " -> "
+              << ms.acmrAfter << ", " << ms.bytesBefore / 1024 << " KB -> " << ms.bytesAfter / 1024 << " KB" << std::endl;
+    std::cout << "  niveles de detalle:";
+    for (const GpuLod& lod : lods) {
+        size_t tris = 0;
+        for (const GpuDrawRange& r : lod.mesh.ranges) tris += r.indexCount / 3;
+        std::cout << " " << lod.mesh.vertexCount << "v/" << tris << "t";
     }
+    std::cout << std::endl;
 
-    NormalizeModel(vertices);
+    // hasta tener las texturas, el color difuso de cada material
+    materialTextures.assign(mesh.materials.size(), TextureRef());
+    pendingTextures.assign(mesh.materials.size(), TextureRef());
+    if (!asset.imagesPending) AddTextures(std::move(asset.images), true);
+}
 
-    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; ++j) {
-            indices.push_back(face.mIndices[j]);
+void ModelRenderer::AddTextures(std::vector<DecodedImage>&& images, bool last) {
+    if (texturesReady) return;
+
+    // cada imagen se decodifico una sola vez; los materiales que repiten la
+    // ruta solo llevan la ruta
+    for (DecodedImage& img : images) {
+        bool first = true;
+        for (size_t i = 0; i < mesh.materials.size(); i++) {
+            if (mesh.materials[i].texturePath != img.path) continue;
+            DecodedImage ref;
+            ref.path = img.path;
+            pendingTextures[i] = textures.Add(first ? std::move(img) : std::move(ref));
+            first = false;
         }
     }
+    if (!last) return;
 
-    aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-    if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
-        aiString str;
-        material->GetTexture(aiTextureType_DIFFUSE, 0, &str);
-        std::string dir = path.substr(0, path.find_last_of("/\\"));
-        std::string texPath = dir + "/" + std::string(str.C_Str());
-        textureID = LoadTexture(texPath);
-    }
-
-    std::cout << "Vertices cargados: " << vertices.size() / 5 << ", Triangulos: " << indices.size() / 3 << std::endl;
-}
-
-GLuint ModelRenderer::LoadTexture(const std::string& filename) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    // Parámetros
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(false);
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    } else {
-        std::cerr << "Error: no se pudo cargar la textura: " << filename << std::endl;
-    }
+    textures.Upload();
+    materialTextures = pendingTextures;
+    texturesReady = true;
 
-    stbi_image_free(data);
-    return textureID;
+    const TextureManager::Stats& ts = textures.GetStats();
+    stats.textures = ts.unique;
+    stats.uploadBytes += ts.gpuBytes;
 }
 
 void ModelRenderer::SetupMesh() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
+    for (GpuLod& lod : lods) {
+        GpuMesh& gm = lod.mesh;
+        glGenVertexArrays(1, &lod.VAO);
+        glGenBuffers(1, &lod.VBO);
+        glGenBuffers(1, &lod.EBO);
+
+        glBindVertexArray(lod.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, lod.VBO);
+        glBufferData(GL_ARRAY_BUFFER, gm.vertices.size() * sizeof(PackedVertex), gm.vertices.data(), GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, gm.indexData.size(), gm.indexData.data(), GL_STATIC_DRAW);
+        stats.uploadBytes += gm.Bytes();
+
+        // posicion SNORM16 y uv UNORM16 normalizadas; el shader las decuantiza
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, uv));
+        glEnableVertexAttribArray(1);
+
+        glBindVertexArray(0);
+
+        // ya en la GPU; quedan los rangos y la decuantizacion
+        std::vector<PackedVertex>().swap(gm.vertices);
+        std::vector<unsigned char>().swap(gm.indexData);
+        lod.dequant = glm::translate(glm::mat4(1.0f), glm::make_vec3(gm.posOffset)) *
+                      glm::scale(glm::mat4(1.0f), glm::make_vec3(gm.posScale));
+    }
 }
 
 void ModelRenderer::SetModelMatrix(const glm::mat4& model) {
@@ -339,6 +329,26 @@ void ModelRenderer::SetViewProjection(const glm::mat4& view, const glm::mat4& pr
     projectionMatrix = projection;
 }
 
+void ModelRenderer::SetAlpha(float a) {
+    alpha = a;
+}
+
+void ModelRenderer::BeginFrame() {
+    stats.drawCalls = 0;
+    stats.triangles = 0;
+    stats.vertices = 0;
+    stats.visible = 0;
+    stats.culled = 0;
+    std::fill(std::begin(stats.lodDraws), std::end(stats.lodDraws), 0u);
+
+    textures.Stream(streamBudget);
+    const TextureManager::StreamStats& ss = textures.GetStreamStats();
+    stats.streamBytes = ss.frameBytes;
+    stats.streamPending = ss.pendingBytes;
+    stats.streamMs = ss.frameMs;
+    stats.stalls = ss.stalls;
+}
+
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -391,22 +401,140 @@ glm::mat4 BuildProjectionMatrix(const cv::Mat& cameraMatrix, float width, float
 
 // ========== Draw ==========
 
-void ModelRenderer::Draw() {
+// Planos (a, b, c, d) de la piramide de vista de la matriz, hacia adentro
+void ModelRenderer::FrustumPlanes(const glm::mat4& m, glm::vec4 planes[6]) {
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; r++) row[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+    for (int i = 0; i < 3; i++) {
+        planes[i * 2] = row[3] + row[i];
+        planes[i * 2 + 1] = row[3] - row[i];
+    }
+}
+
+// Afuera si la caja queda del lado negativo de algun plano
+bool ModelRenderer::BoxOutside(const glm::vec4 planes[6], const float* lo, const float* hi) {
+    glm::vec3 center = 0.5f * (glm::make_vec3(lo) + glm::make_vec3(hi));
+    glm::vec3 extent = 0.5f * (glm::make_vec3(hi) - glm::make_vec3(lo));
+    for (int i = 0; i < 6; i++) {
+        glm::vec3 n(planes[i]);
+        float dist = glm::dot(n, center) + planes[i].w;
+        float radius = glm::dot(glm::abs(n), extent);
+        if (dist + radius < 0.0f) return true;
+    }
+    return false;
+}
+
+// Diametro de la esfera envolvente proyectada, en altos de pantalla
+float ModelRenderer::ScreenSize() const {
+    glm::mat4 modelView = viewMatrix * modelMatrix;
+    glm::vec3 center = glm::vec3(modelView * glm::vec4(boundsCenter, 1.0f));
+    float scale = std::max({ glm::length(glm::vec3(modelView[0])), glm::length(glm::vec3(modelView[1])),
+                             glm::length(glm::vec3(modelView[2])) });
+    float radius = boundsRadius * scale;
+    float depth = -center.z;
+    if (depth <= radius) return 1e9f;   // camara dentro o detras: maximo detalle
+    return radius * projectionMatrix[1][1] / depth;
+}
+
+// Un nivel mas por cada mitad de tamanio; solo se cambia si se pasa el
+// limite por un margen, para que no parpadee en la frontera
+int ModelRenderer::SelectLod(float screenSize, int current) const {
+    int count = (int)lods.size();
+    int target = 0;
+    for (float limit = LOD_SCREEN_SIZE; target + 1 < count && screenSize < limit; limit *= 0.5f) target++;
+    if (current < 0 || current >= count || target == current) return target;
+
+    if (target > current) {
+        float limit = LOD_SCREEN_SIZE * std::pow(0.5f, (float)current);
+        return screenSize < limit * (1.0f - LOD_HYSTERESIS) ? target : current;
+    }
+    float limit = LOD_SCREEN_SIZE * std::pow(0.5f, (float)(current - 1));
+    return screenSize > limit * (1.0f + LOD_HYSTERESIS) ? target : current;
+}
+
+void ModelRenderer::Draw(int instance) {
+    if (lods.empty()) return;
+    auto state = lodStates.emplace(instance, -1).first;
+    int& lodState = state->second;
+    lodState = SelectLod(ScreenSize(), lodState);
+    const GpuLod& lod = lods[lodState];
+    const GpuMesh& gpuMesh = lod.mesh;
+
+    // descartar los rangos fuera de la vista; las cajas estan en espacio del modelo
+    glm::vec4 planes[6];
+    FrustumPlanes(projectionMatrix * viewMatrix * modelMatrix, planes);
+    visibleRanges.clear();
+    for (const GpuDrawRange& range : gpuMesh.ranges) {
+        if (BoxOutside(planes, range.boundsMin, range.boundsMax)) stats.culled++;
+        else visibleRanges.push_back(&range);
+    }
+    stats.visible += (unsigned int)visibleRanges.size();
+    if (visibleRanges.empty()) return;
+
     glUseProgram(shaderProgram);
 
     GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
     GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
     GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
 
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+    glm::mat4 model = modelMatrix * lod.dequant;
+    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
     glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(viewMatrix));
     glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+    glUniform4f(glGetUniformLocation(shaderProgram, "uvTransform"), gpuMesh.uvOffset[0], gpuMesh.uvOffset[1],
+                gpuMesh.uvScale[0], gpuMesh.uvScale[1]);
+
+    // todas las texturas del modelo quedan enlazadas para todo el dibujo
+    textures.Bind(GL_TEXTURE0);
+    glUniform1f(glGetUniformLocation(shaderProgram, "alpha"), alpha);
+    GLint arrayLoc = glGetUniformLocation(shaderProgram, "textureArray");
+    GLint layerLoc = glGetUniformLocation(shaderProgram, "textureLayer");
+    GLint diffuseLoc = glGetUniformLocation(shaderProgram, "diffuseColor");
+
+    // translucido: mezcla sin escribir profundidad, para no tapar lo que se dibuje despues
+    bool translucent = alpha < 1.0f;
+    if (translucent) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+    }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glUniform1i(glGetUniformLocation(shaderProgram, "texture_diffuse1"), 0);
+    // un draw por material: los rangos visibles seguidos del mismo material
+    // (vienen ordenados asi) van juntos en un glMultiDrawElementsBaseVertex
+    glBindVertexArray(lod.VAO);
+    stats.lodDraws[lodState]++;
+    for (size_t i = 0; i < visibleRanges.size();) {
+        const GpuDrawRange& first = *visibleRanges[i];
+        drawCounts.clear();
+        drawOffsets.clear();
+        drawBases.clear();
+        size_t j = i;
+        for (; j < visibleRanges.size() && visibleRanges[j]->material == first.material &&
+               visibleRanges[j]->shortIndices == first.shortIndices; j++) {
+            const GpuDrawRange& range = *visibleRanges[j];
+            drawCounts.push_back(static_cast<GLsizei>(range.indexCount));
+            drawOffsets.push_back((const void*)range.byteOffset);
+            drawBases.push_back(range.baseVertex);
+            stats.triangles += range.indexCount / 3;
+            stats.vertices += range.vertexSpan;
+        }
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+        const MeshMaterial& material = mesh.materials[first.material];
+        const TextureRef& tex = materialTextures[first.material];
+        glUniform1i(arrayLoc, tex.array);
+        glUniform1f(layerLoc, (float)tex.layer);
+        glUniform3fv(diffuseLoc, 1, material.diffuse);
+
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(),
+                                      first.shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                                      drawOffsets.data(), static_cast<GLsizei>(drawCounts.size()), drawBases.data());
+        stats.drawCalls++;
+        i = j;
+    }
     glBindVertexArray(0);
+
+    if (translucent) {
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
 }
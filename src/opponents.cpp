@@ -0,0 +1,88 @@
+#include "../include/opponents.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+float wrapAngle(float a) {
+    const float pi = 3.14159265f;
+    while (a > pi) a -= 2.0f * pi;
+    while (a < -pi) a += 2.0f * pi;
+    return a;
+}
+}
+
+void Opponents::Reset(const RacingLine& line, int count) {
+    size_t n = line.Empty() ? 0 : (size_t)std::max(0, count);
+    for (auto* v : { &x, &y, &z, &heading, &speed, &prevX, &prevY, &prevZ, &prevHeading, &topSpeed, &yawRate, &targetSpeed })
+        v->assign(n, 0.0f);
+    segment.assign(n, 0);
+    if (n == 0) return;
+
+    // de a dos por fila, detras de la muestra 0
+    int numPoints = (int)line.points.size();
+    int rowGap = std::max(1, (int)std::ceil(0.6f / std::max(line.Spacing(), 1e-4f)));
+    for (size_t i = 0; i < n; i++) {
+        int idx = ((numPoints - (int)(i / 2 + 1) * rowGap) % numPoints + numPoints) % numPoints;
+        glm::vec2 p = line.points[idx];
+        glm::vec2 d = line.points[(idx + 1) % numPoints] - p;
+        float h = std::atan2(d.x, d.y);
+        float side = (i % 2 ? 0.2f : -0.2f);
+        x[i] = p.x + std::cos(h) * side;
+        z[i] = p.y - std::sin(h) * side;
+        y[i] = line.Height(x[i], z[i]);
+        heading[i] = h;
+        segment[i] = idx;
+        // cada carro con un poco mas o menos de velocidad
+        topSpeed[i] = params.velocidadMax * (0.85f + 0.3f * float((i * 7) % 11) / 10.0f);
+    }
+    prevX = x; prevY = y; prevZ = z; prevHeading = heading;
+}
+
+void Opponents::Update(const RacingLine& line, float dt) {
+    const size_t n = Size();
+    if (n == 0 || line.Empty()) return;
+
+    prevX = x; prevY = y; prevZ = z; prevHeading = heading;
+
+    const int numPoints = (int)line.points.size();
+    const int ahead = std::max(1, (int)(params.lookahead / std::max(line.Spacing(), 1e-4f)));
+    const int window = ahead + 4;
+    const float probe = 0.5f * params.lookahead;
+
+    // 1) decisiones: consultas a la linea y al campo de distancia
+    for (size_t i = 0; i < n; i++) {
+        glm::vec2 p(x[i], z[i]);
+        segment[i] = line.Nearest(p, segment[i], window);
+        glm::vec2 target = line.points[(segment[i] + ahead) % numPoints];
+
+        glm::vec2 fwd(std::sin(heading[i]), std::cos(heading[i]));
+        float err = wrapAngle(std::atan2(target.x - p.x, target.y - p.y) - heading[i]);
+
+        // cerca del borde: girar hacia el interior segun el gradiente del campo
+        glm::vec2 q = p + fwd * probe;
+        float d = line.Distance(q.x, q.y);
+        if (d < params.margen) {
+            glm::vec2 g = line.Gradient(q.x, q.y);
+            float cross = fwd.y * g.x - fwd.x * g.y;
+            err += params.gananciaBorde * (1.0f - d / params.margen) * (cross >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        yawRate[i] = std::max(-params.giroMax, std::min(params.giroMax, params.gananciaGiro * err));
+        targetSpeed[i] = topSpeed[i] * (1.0f - 0.5f * std::min(1.0f, std::fabs(err)));
+    }
+
+    // 2) integracion: solo aritmetica sobre arreglos contiguos
+    const float accel = params.aceleracion * dt;
+    for (size_t i = 0; i < n; i++) {
+        float dv = std::max(-accel, std::min(accel, targetSpeed[i] - speed[i]));
+        speed[i] += dv;
+        heading[i] += yawRate[i] * dt;
+    }
+    for (size_t i = 0; i < n; i++) {
+        x[i] += std::sin(heading[i]) * speed[i] * dt;
+        z[i] += std::cos(heading[i]) * speed[i] * dt;
+    }
+    for (size_t i = 0; i < n; i++)
+        y[i] = line.Height(x[i], z[i]);
+}
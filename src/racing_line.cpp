@@ -0,0 +1,270 @@
+#include "../include/racing_line.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+
+namespace {
+glm::vec2 catmullRom(const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, float t) {
+    float t2 = t * t, t3 = t2 * t;
+    return 0.5f * ((2.0f * p1) + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+void hashBytes(uint64_t& h, const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+}
+}
+
+uint64_t RacingLine::HashMesh(const MeshData& mesh, const glm::mat4& transform) {
+    // FNV-1a sobre la geometria y la transformacion
+    uint64_t h = 14695981039346656037ull;
+    hashBytes(h, mesh.vertices.data(), mesh.vertices.size() * sizeof(float));
+    hashBytes(h, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+    hashBytes(h, &transform[0][0], sizeof(glm::mat4));
+    return h;
+}
+
+bool RacingLine::LoadOrBake(const std::string& cachePath, const MeshData& mesh, const glm::mat4& transform) {
+    uint64_t h = HashMesh(mesh, transform);
+    if (!cachePath.empty() && LoadCache(cachePath, h)) {
+        std::cout << "Linea de carrera cargada de " << cachePath << "\n";
+        return true;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (!Bake(mesh, transform)) return false;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "Linea de carrera horneada: " << points.size() << " muestras, longitud " << Length()
+              << ", campo " << field.cols << "x" << field.rows << " (" << ms << " ms)\n";
+
+    if (!cachePath.empty() && SaveCache(cachePath, h))
+        std::cout << "Cache de la pista guardada en " << cachePath << "\n";
+    return true;
+}
+
+bool RacingLine::Bake(const MeshData& mesh, const glm::mat4& transform, int resolution) {
+    points.clear();
+    arc.clear();
+    const int stride = MeshData::VERTEX_STRIDE;
+
+    // zona transitable: triangulos casi horizontales (la normal puede venir invertida)
+    std::vector<glm::vec3> tris;
+    glm::vec2 bmin(std::numeric_limits<float>::max()), bmax(-std::numeric_limits<float>::max());
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        glm::vec3 v[3];
+        for (int k = 0; k < 3; k++) {
+            const float* p = &mesh.vertices[mesh.indices[i + k] * stride];
+            v[k] = glm::vec3(transform * glm::vec4(p[0], p[1], p[2], 1.0f));
+        }
+        glm::vec3 n = glm::cross(v[1] - v[0], v[2] - v[0]);
+        float len = glm::length(n);
+        if (len <= 0.0f || std::fabs(n.y) < 0.7f * len) continue;
+
+        for (int k = 0; k < 3; k++) {
+            tris.push_back(v[k]);
+            bmin.x = std::min(bmin.x, v[k].x); bmax.x = std::max(bmax.x, v[k].x);
+            bmin.y = std::min(bmin.y, v[k].z); bmax.y = std::max(bmax.y, v[k].z);
+        }
+    }
+    if (tris.empty()) {
+        std::cerr << "RacingLine: la pista no tiene superficie transitable\n";
+        return false;
+    }
+
+    // rasterizar en una rejilla xz, con 4 celdas de borde
+    const int pad = 4;
+    glm::vec2 extent = bmax - bmin;
+    cellSize = std::max(extent.x, extent.y) / resolution;
+    origin = bmin - glm::vec2(pad * cellSize);
+    int cols = (int)std::ceil(extent.x / cellSize) + 2 * pad + 1;
+    int rows = (int)std::ceil(extent.y / cellSize) + 2 * pad + 1;
+
+    cv::Mat mask = cv::Mat::zeros(rows, cols, CV_8U);
+    height = cv::Mat::zeros(rows, cols, CV_32F);
+    const int shift = 4;   // coordenadas subpixel
+    const float sub = float(1 << shift) / cellSize;
+    for (size_t i = 0; i < tris.size(); i += 3) {
+        cv::Point pts[3];
+        float y = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            pts[k] = cv::Point(cvRound((tris[i + k].x - origin.x) * sub), cvRound((tris[i + k].z - origin.y) * sub));
+            y += tris[i + k].y / 3.0f;
+        }
+        cv::fillConvexPoly(mask, pts, 3, cv::Scalar(255), cv::LINE_8, shift);
+        cv::fillConvexPoly(height, pts, 3, cv::Scalar(y), cv::LINE_8, shift);
+    }
+    // unir triangulos que no comparten el borde exacto
+    cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, cv::Mat());
+
+    cv::Mat inside, outside, inv;
+    cv::distanceTransform(mask, inside, cv::DIST_L2, 5);
+    cv::bitwise_not(mask, inv);
+    cv::distanceTransform(inv, outside, cv::DIST_L2, 5);
+    field = (inside - outside) * cellSize;
+
+    // linea central: en cada direccion desde el centro del circuito, el punto mas alejado de los bordes
+    cv::Moments m = cv::moments(mask, true);
+    if (m.m00 <= 0) return false;
+    glm::vec2 center = origin + glm::vec2(float(m.m10 / m.m00), float(m.m01 / m.m00)) * cellSize;
+    float maxR = std::sqrt(float(cols * cols + rows * rows)) * cellSize;
+
+    const int numAngles = 128;
+    std::vector<glm::vec2> ctrl;
+    for (int a = 0; a < numAngles; a++) {
+        float th = float(2.0 * CV_PI * a / numAngles);
+        glm::vec2 dir(std::cos(th), std::sin(th));
+        float best = 0.0f;
+        glm::vec2 bestP;
+        for (float r = 0.0f; r < maxR; r += 0.5f * cellSize) {
+            glm::vec2 p = center + dir * r;
+            float d = Distance(p.x, p.y);
+            if (d > best) { best = d; bestP = p; }
+        }
+        if (best > 0.0f) ctrl.push_back(bestP);
+    }
+    if (ctrl.size() < 8) {
+        std::cerr << "RacingLine: no se encontro un circuito cerrado\n";
+        return false;
+    }
+
+    // linea de carrera: suavizado iterativo (aproxima curvatura minima) sin acercarse al borde
+    std::vector<float> half;
+    for (const auto& p : ctrl) half.push_back(Distance(p.x, p.y));
+    std::nth_element(half.begin(), half.begin() + half.size() / 2, half.end());
+    float margin = 0.35f * half[half.size() / 2];
+
+    size_t n = ctrl.size();
+    for (int it = 0; it < 100; it++) {
+        std::vector<glm::vec2> next = ctrl;
+        for (size_t i = 0; i < n; i++) {
+            glm::vec2 avg = 0.5f * (ctrl[(i + n - 1) % n] + ctrl[(i + 1) % n]);
+            glm::vec2 q = ctrl[i] + 0.5f * (avg - ctrl[i]);
+            if (Distance(q.x, q.y) >= margin) next[i] = q;
+        }
+        ctrl.swap(next);
+    }
+
+    // spline Catmull-Rom cerrada, muestreada densamente
+    const int perSegment = 8;
+    for (size_t i = 0; i < n; i++) {
+        const glm::vec2& p0 = ctrl[(i + n - 1) % n];
+        const glm::vec2& p1 = ctrl[i];
+        const glm::vec2& p2 = ctrl[(i + 1) % n];
+        const glm::vec2& p3 = ctrl[(i + 2) % n];
+        for (int k = 0; k < perSegment; k++)
+            points.push_back(catmullRom(p0, p1, p2, p3, float(k) / perSegment));
+    }
+    UpdateArc();
+    return true;
+}
+
+void RacingLine::UpdateArc() {
+    arc.resize(points.size());
+    float total = 0.0f;
+    for (size_t i = 0; i < points.size(); i++) {
+        total += glm::distance(points[i], points[(i + 1) % points.size()]);
+        arc[i] = total;
+    }
+}
+
+bool RacingLine::SaveCache(const std::string& path, uint64_t meshHash) const {
+    if (Empty()) return false;
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)meshHash);
+    fs << "version" << CACHE_VERSION;
+    fs << "meshHash" << std::string(hex);
+    fs << "origin" << cv::Point2f(origin.x, origin.y);
+    fs << "cellSize" << cellSize;
+    fs << "field" << field;
+    fs << "height" << height;
+    fs << "line" << cv::Mat((int)points.size(), 2, CV_32F, const_cast<glm::vec2*>(points.data()));
+    return true;
+}
+
+bool RacingLine::LoadCache(const std::string& path, uint64_t meshHash) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) return false;
+
+    int version = 0;
+    std::string hash;
+    fs["version"] >> version;
+    fs["meshHash"] >> hash;
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)meshHash);
+    if (version != CACHE_VERSION || hash != hex) return false;
+
+    cv::Point2f o;
+    cv::Mat line;
+    fs["origin"] >> o;
+    fs["cellSize"] >> cellSize;
+    fs["field"] >> field;
+    fs["height"] >> height;
+    fs["line"] >> line;
+    if (field.type() != CV_32F || height.size() != field.size() || line.type() != CV_32F || line.cols != 2) {
+        std::cerr << "RacingLine: cache invalida en " << path << "\n";
+        points.clear();
+        return false;
+    }
+
+    origin = glm::vec2(o.x, o.y);
+    points.resize(line.rows);
+    for (int i = 0; i < line.rows; i++)
+        points[i] = glm::vec2(line.at<float>(i, 0), line.at<float>(i, 1));
+    UpdateArc();
+    return true;
+}
+
+float RacingLine::Sample(const cv::Mat& grid, float x, float z) const {
+    float gx = std::max(0.0f, std::min((x - origin.x) / cellSize, float(grid.cols - 1) - 1e-3f));
+    float gz = std::max(0.0f, std::min((z - origin.y) / cellSize, float(grid.rows - 1) - 1e-3f));
+    int c = (int)gx, r = (int)gz;
+    float fx = gx - c, fz = gz - r;
+    const float* row0 = grid.ptr<float>(r);
+    const float* row1 = grid.ptr<float>(r + 1);
+    float top = row0[c] + (row0[c + 1] - row0[c]) * fx;
+    float bottom = row1[c] + (row1[c + 1] - row1[c]) * fx;
+    return top + (bottom - top) * fz;
+}
+
+float RacingLine::Distance(float x, float z) const {
+    return field.empty() ? 0.0f : Sample(field, x, z);
+}
+
+float RacingLine::Height(float x, float z) const {
+    return height.empty() ? 0.0f : Sample(height, x, z);
+}
+
+glm::vec2 RacingLine::Gradient(float x, float z) const {
+    float h = cellSize;
+    return glm::vec2(Distance(x + h, z) - Distance(x - h, z), Distance(x, z + h) - Distance(x, z - h));
+}
+
+int RacingLine::Nearest(const glm::vec2& p, int hint, int window) const {
+    int n = (int)points.size();
+    if (n == 0) return -1;
+    if (hint < 0 || window * 2 + 1 >= n) {
+        hint = 0;
+        window = n / 2;
+    }
+
+    int best = hint;
+    float bestD = std::numeric_limits<float>::max();
+    for (int k = -window; k <= window; k++) {
+        int i = ((hint + k) % n + n) % n;
+        glm::vec2 d = points[i] - p;
+        float d2 = glm::dot(d, d);
+        if (d2 < bestD) { bestD = d2; best = i; }
+    }
+    return best;
+}
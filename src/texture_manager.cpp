@@ -0,0 +1,249 @@
+#include "../include/texture_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "../include/stb_image.h"
+
+namespace {
+size_t mipChainBytes(int width, int height) {
+    size_t total = 0;
+    while (true) {
+        total += (size_t)width * height * 4;
+        if (width == 1 && height == 1) break;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return total;
+}
+}
+
+bool TextureManager::Decode(const std::string& path, const AssetPack* pack, DecodedImage& img) {
+    img.path = path;
+
+    // del paquete (ya con mipmaps y hash) o decodificada con stb
+    if (pack && pack->FindTexture(path, img.packed)) {
+        img.width = img.packed.width;
+        img.height = img.packed.height;
+        img.levels = img.packed.levels;
+        img.hash = img.packed.hash;
+        return true;
+    }
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!data) {
+        std::cerr << "Error: no se pudo cargar la textura: " << path << std::endl;
+        return false;
+    }
+    // los mipmaps se calculan aqui (hilo de carga) para poder subirlos de
+    // grueso a fino sin glGenerateMipmap
+    img.width = width;
+    img.height = height;
+    img.levels = MipLevelCount(width, height);
+    img.hash = HashImage(width, height, data, (size_t)width * height * 4);
+    BuildMipChain(data, width, height, img.pixels);
+    stbi_image_free(data);
+    return true;
+}
+
+const unsigned char* DecodedImage::Level(int level) const {
+    if (packed.data) return packed.Level(level);
+    const unsigned char* p = pixels.data();
+    for (int l = 0; l < level; l++) p += PackedTexture::LevelBytes(width, height, l);
+    return p;
+}
+
+TextureRef TextureManager::Add(DecodedImage&& decoded) {
+    const std::string& path = decoded.path;
+    stats.references++;
+
+    auto known = byPath.find(path);
+    if (known != byPath.end()) {
+        if (known->second.array >= 0) {
+            const Array& a = arrays[known->second.array];
+            stats.decodeBytesSaved += (size_t)a.width * a.height * 4;
+            stats.gpuBytesSaved += mipChainBytes(a.width, a.height);
+        }
+        return known->second;
+    }
+    if (!decoded.Valid()) return byPath[path] = TextureRef();
+
+    int width = decoded.width, height = decoded.height;
+    if (decoded.packed.data) {
+        stats.packed++;
+    } else {
+        stats.decoded++;
+        stats.decodedBytes += (size_t)width * height * 4;
+    }
+
+    // mismo contenido con otra ruta: se reutiliza la capa
+    auto same = byHash.find(decoded.hash);
+    if (same != byHash.end()) {
+        stats.gpuBytesSaved += mipChainBytes(width, height);
+        return byPath[path] = same->second;
+    }
+
+    // un arreglo por tamanio
+    int arrayIndex = -1;
+    for (size_t i = 0; i < arrays.size(); i++)
+        if (arrays[i].width == width && arrays[i].height == height) arrayIndex = (int)i;
+    if (arrayIndex < 0) {
+        if ((int)arrays.size() == MAX_ARRAYS) {
+            std::cerr << "TextureManager: demasiados tamanios distintos, se omite " << path << std::endl;
+            return byPath[path] = TextureRef();
+        }
+        Array a;
+        a.width = width;
+        a.height = height;
+        a.layers = 0;
+        a.id = 0;
+        a.levels = MipLevelCount(width, height);
+        a.baseLevel = a.levels;
+        arrays.push_back(a);
+        arrayIndex = (int)arrays.size() - 1;
+    }
+
+    Image img;
+    img.data = std::move(decoded);
+    img.pendingLevels = img.data.levels;
+    img.ref.array = arrayIndex;
+    img.ref.layer = arrays[arrayIndex].layers++;
+
+    images.push_back(std::move(img));
+    stats.unique++;
+    byHash[images.back().data.hash] = images.back().ref;
+    return byPath[images.back().data.path] = images.back().ref;
+}
+
+void TextureManager::Upload() {
+    for (Array& a : arrays) {
+        glGenTextures(1, &a.id);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, a.id);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, a.levels - 1);
+        for (int level = 0; level < a.levels; level++)
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, a.width >> level),
+                         std::max(1, a.height >> level), a.layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        a.pendingLayers.assign(a.levels, a.layers);
+        stats.gpuBytes += mipChainBytes(a.width, a.height) * a.layers;
+    }
+
+    // cola de grueso a fino entre todos los arreglos
+    uploads.clear();
+    next = 0;
+    for (size_t i = 0; i < images.size(); i++)
+        for (int level = 0; level < images[i].data.levels; level++)
+            uploads.push_back({ (int)i, level, 0 });
+    auto levelBytes = [&](const LevelUpload& u) {
+        const DecodedImage& d = images[u.image].data;
+        return PackedTexture::LevelBytes(d.width, d.height, u.level);
+    };
+    std::stable_sort(uploads.begin(), uploads.end(), [&](const LevelUpload& x, const LevelUpload& y) {
+        return levelBytes(x) < levelBytes(y);
+    });
+    streamStats.pendingBytes = 0;
+    for (const LevelUpload& u : uploads) streamStats.pendingBytes += levelBytes(u);
+
+    // marcador: el nivel 1x1 de todas las capas ya, el resto con Stream
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    while (Streaming()) {
+        LevelUpload& u = uploads[next];
+        const Array& a = arrays[images[u.image].ref.array];
+        if (u.level != a.levels - 1) break;
+        UploadRows(u, 1);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    std::cout << "Texturas: " << stats.references << " referencias, " << stats.decoded << " decodificadas, "
+              << stats.packed << " del paquete, "
+              << stats.unique << " unicas en " << arrays.size() << " arreglos | decodificado "
+              << stats.decodedBytes / (1024 * 1024) << " MB (ahorro " << stats.decodeBytesSaved / (1024 * 1024)
+              << " MB), GPU " << stats.gpuBytes / (1024 * 1024) << " MB (ahorro "
+              << stats.gpuBytesSaved / (1024 * 1024) << " MB)" << std::endl;
+}
+
+void TextureManager::Stream(size_t budgetBytes) {
+    streamStats.budget = budgetBytes;
+    streamStats.frameBytes = 0;
+    streamStats.frameMs = 0;
+    if (!Streaming()) return;
+
+    auto start = std::chrono::steady_clock::now();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    while (Streaming()) {
+        LevelUpload& u = uploads[next];
+        const DecodedImage& d = images[u.image].data;
+        size_t rowBytes = (size_t)std::max(1, d.width >> u.level) * 4;
+        size_t left = budgetBytes > streamStats.frameBytes ? budgetBytes - streamStats.frameBytes : 0;
+        // al menos una fila por frame para no quedar trabado con presupuestos chicos
+        int rows = (int)(left / rowBytes);
+        if (rows == 0) {
+            if (streamStats.frameBytes > 0) break;
+            rows = 1;
+        }
+        UploadRows(u, rows);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    streamStats.frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    streamStats.maxFrameMs = std::max(streamStats.maxFrameMs, streamStats.frameMs);
+    streamStats.frames++;
+    if (streamStats.frameMs > STALL_MS) streamStats.stalls++;
+    if (!Streaming())
+        std::cout << "Texturas completas: " << streamStats.totalBytes / (1024 * 1024) << " MB en "
+                  << streamStats.frames << " frames (max " << streamStats.maxFrameMs << " ms, "
+                  << streamStats.stalls << " frames > " << STALL_MS << " ms)" << std::endl;
+}
+
+void TextureManager::UploadRows(LevelUpload& u, int rows) {
+    Image& img = images[u.image];
+    const DecodedImage& d = img.data;
+    int w = std::max(1, d.width >> u.level), h = std::max(1, d.height >> u.level);
+    rows = std::min(rows, h - u.row);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[img.ref.array].id);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, u.level, 0, u.row, img.ref.layer, w, rows, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                    d.Level(u.level) + (size_t)u.row * w * 4);
+
+    size_t bytes = (size_t)rows * w * 4;
+    streamStats.frameBytes += bytes;
+    streamStats.totalBytes += bytes;
+    streamStats.pendingBytes -= bytes;
+    u.row += rows;
+    if (u.row == h) {
+        FinishLevel(u);
+        next++;
+    }
+}
+
+void TextureManager::FinishLevel(const LevelUpload& u) {
+    Image& img = images[u.image];
+    Array& a = arrays[img.ref.array];
+
+    // muestrear solo niveles que ya estan en todas las capas
+    a.pendingLayers[u.level]--;
+    int base = a.baseLevel;
+    while (base > 0 && a.pendingLayers[base - 1] == 0) base--;
+    if (base != a.baseLevel) {
+        a.baseLevel = base;
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, base);
+    }
+
+    if (--img.pendingLevels == 0) {
+        std::vector<unsigned char>().swap(img.data.pixels);
+        img.data.packed = PackedTexture();
+    }
+}
+
+void TextureManager::Bind(GLenum firstUnit) const {
+    for (size_t i = 0; i < arrays.size(); i++) {
+        glActiveTexture(firstUnit + (GLenum)i);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[i].id);
+    }
+}
@@ -0,0 +1,192 @@
+#include "../include/track_bvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+bool RayBox(const glm::vec3& origin, const glm::vec3& invDir, const glm::vec3& bmin, const glm::vec3& bmax,
+            float maxT, float& tNear) {
+    glm::vec3 t0 = (bmin - origin) * invDir;
+    glm::vec3 t1 = (bmax - origin) * invDir;
+    glm::vec3 tmin = glm::min(t0, t1), tmax = glm::max(t0, t1);
+    float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+    float exit  = std::min(std::min(tmax.x, tmax.y), std::min(tmax.z, maxT));
+    tNear = enter;
+    return enter <= exit;
+}
+}
+
+void TrackBVH::Build(const MeshData& mesh, const glm::mat4& transform) {
+    nodes.clear();
+    v0.clear(); e1.clear(); e2.clear();
+    depth = 0;
+
+    const int stride = MeshData::VERTEX_STRIDE;
+    size_t numTris = mesh.TriangleCount();
+    if (numTris == 0) return;
+
+    std::vector<glm::vec3> a(numTris), b(numTris), c(numTris), centroid(numTris);
+    auto vertex = [&](unsigned int idx) {
+        const float* v = &mesh.vertices[idx * stride];
+        return glm::vec3(transform * glm::vec4(v[0], v[1], v[2], 1.0f));
+    };
+    for (size_t i = 0; i < numTris; i++) {
+        a[i] = vertex(mesh.indices[3 * i]);
+        b[i] = vertex(mesh.indices[3 * i + 1]);
+        c[i] = vertex(mesh.indices[3 * i + 2]);
+        centroid[i] = (a[i] + b[i] + c[i]) / 3.0f;
+    }
+
+    std::vector<int> order(numTris);
+    for (size_t i = 0; i < numTris; i++) order[i] = (int)i;
+
+    // construccion iterativa: division por la mediana en el eje mas largo de los centroides
+    struct Pending { int node, first, count, level; };
+    std::vector<Pending> stack;
+    nodes.reserve(2 * numTris / LEAF_SIZE + 1);
+    nodes.push_back(Node());
+    stack.push_back({ 0, 0, (int)numTris, 1 });
+
+    while (!stack.empty()) {
+        Pending p = stack.back();
+        stack.pop_back();
+        depth = std::max(depth, p.level);
+
+        glm::vec3 bmin(std::numeric_limits<float>::max()), bmax(-std::numeric_limits<float>::max());
+        glm::vec3 cmin = bmin, cmax = bmax;
+        for (int i = p.first; i < p.first + p.count; i++) {
+            int t = order[i];
+            bmin = glm::min(bmin, glm::min(a[t], glm::min(b[t], c[t])));
+            bmax = glm::max(bmax, glm::max(a[t], glm::max(b[t], c[t])));
+            cmin = glm::min(cmin, centroid[t]);
+            cmax = glm::max(cmax, centroid[t]);
+        }
+        nodes[p.node].bmin = bmin;
+        nodes[p.node].bmax = bmax;
+
+        glm::vec3 extent = cmax - cmin;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        if (p.count <= LEAF_SIZE || extent[axis] <= 0.0f) {
+            nodes[p.node].left = -1;
+            nodes[p.node].first = p.first;
+            nodes[p.node].count = p.count;
+            continue;
+        }
+
+        int half = p.count / 2;
+        std::nth_element(order.begin() + p.first, order.begin() + p.first + half, order.begin() + p.first + p.count,
+                         [&](int i, int j) { return centroid[i][axis] < centroid[j][axis]; });
+
+        int left = (int)nodes.size();
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        nodes[p.node].left = left;
+        nodes[p.node].first = 0;
+        nodes[p.node].count = 0;
+        stack.push_back({ left, p.first, half, p.level + 1 });
+        stack.push_back({ left + 1, p.first + half, p.count - half, p.level + 1 });
+    }
+
+    // triangulos en el orden de las hojas, para recorrerlos en memoria contigua
+    v0.resize(numTris); e1.resize(numTris); e2.resize(numTris);
+    for (size_t i = 0; i < numTris; i++) {
+        int t = order[i];
+        v0[i] = a[t];
+        e1[i] = b[t] - a[t];
+        e2[i] = c[t] - a[t];
+    }
+}
+
+bool TrackBVH::IntersectTriangle(int tri, const glm::vec3& origin, const glm::vec3& dir, float maxT, float& t) const {
+    // Moller-Trumbore, sin descartar caras traseras
+    const float eps = 1e-8f;
+    glm::vec3 pvec = glm::cross(dir, e2[tri]);
+    float det = glm::dot(e1[tri], pvec);
+    if (std::fabs(det) < eps) return false;
+    float invDet = 1.0f / det;
+
+    glm::vec3 tvec = origin - v0[tri];
+    float u = glm::dot(tvec, pvec) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    glm::vec3 qvec = glm::cross(tvec, e1[tri]);
+    float v = glm::dot(dir, qvec) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    t = glm::dot(e2[tri], qvec) * invDet;
+    return t >= 0.0f && t <= maxT;
+}
+
+void TrackBVH::FillHit(int tri, const glm::vec3& origin, const glm::vec3& dir, float t, TrackHit& hit) const {
+    hit.t = t;
+    hit.point = origin + dir * t;
+    hit.normal = glm::normalize(glm::cross(e1[tri], e2[tri]));
+    hit.triangle = tri;
+}
+
+bool TrackBVH::Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT, TrackHit& hit) const {
+    if (nodes.empty()) return false;
+
+    glm::vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+    float best = maxT;
+    int bestTri = -1;
+
+    int stack[64];
+    int top = 0;
+    float tNear;
+    if (!RayBox(origin, invDir, nodes[0].bmin, nodes[0].bmax, best, tNear)) return false;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                float t;
+                if (IntersectTriangle(i, origin, dir, best, t)) {
+                    best = t;
+                    bestTri = i;
+                }
+            }
+            continue;
+        }
+
+        // primero el hijo mas cercano; el lejano se descarta si ya hay un impacto antes
+        float tl, tr;
+        bool hl = RayBox(origin, invDir, nodes[node.left].bmin, nodes[node.left].bmax, best, tl);
+        bool hr = RayBox(origin, invDir, nodes[node.left + 1].bmin, nodes[node.left + 1].bmax, best, tr);
+        if (hl && hr) {
+            bool leftFirst = tl <= tr;
+            stack[top++] = leftFirst ? node.left + 1 : node.left;
+            stack[top++] = leftFirst ? node.left : node.left + 1;
+        } else if (hl) {
+            stack[top++] = node.left;
+        } else if (hr) {
+            stack[top++] = node.left + 1;
+        }
+    }
+
+    if (bestTri < 0) return false;
+    FillHit(bestTri, origin, dir, best, hit);
+    return true;
+}
+
+bool TrackBVH::RaycastBruteForce(const glm::vec3& origin, const glm::vec3& dir, float maxT, TrackHit& hit) const {
+    float best = maxT;
+    int bestTri = -1;
+    for (int i = 0; i < (int)v0.size(); i++) {
+        float t;
+        if (IntersectTriangle(i, origin, dir, best, t)) {
+            best = t;
+            bestTri = i;
+        }
+    }
+    if (bestTri < 0) return false;
+    FillHit(bestTri, origin, dir, best, hit);
+    return true;
+}
+
+bool TrackBVH::GroundHeight(const glm::vec3& p, const glm::vec3& up, float above, float below, TrackHit& hit) const {
+    return Raycast(p + up * above, -up, above + below, hit);
+}
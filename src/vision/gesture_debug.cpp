@@ -0,0 +1,59 @@
+#include "../../include/vision/gesture_recognition.h"
+#include <string>
+
+// Visualizacion de depuracion, separada del camino de produccion
+void VisionProcessor::renderDebug(const Mat& inFrame, Mat& out) const {
+    inFrame.copyTo(out);
+
+    // modo de varias manos: caja e ID de cada una
+    for (const auto& h : hands) {
+        if (!h.det.features.detected) continue;
+        rectangle(out, h.det.features.box, Scalar(255, 0, 255), 2);
+        putText(out, "J" + to_string(h.player + 1) + " #" + to_string(h.id) + " " + gestureName(h.tracker->current()),
+                h.det.features.box.tl() + Point(0, -5), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 0, 255), 1);
+    }
+
+    if (!handDetected) {
+        putText(out, "No hand detected", Point(20, 30), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0, 0, 255), 2);
+        return;
+    }
+
+    drawContours(out, vector<vector<Point>>{contour}, 0, Scalar(0, 255, 0), 2);
+    polylines(out, hull, true, Scalar(255, 0, 0), 2);
+
+    Point2f pointOnLine(fittingLine[2], fittingLine[3]);
+    Point2f direction(fittingLine[0], fittingLine[1]);
+
+    float length = 200.0f;
+    Point2f p1 = pointOnLine - direction * length;
+    Point2f p2 = pointOnLine + direction * length;
+
+    line(out,
+        Point(cvRound(p1.x), cvRound(p1.y)),
+        Point(cvRound(p2.x), cvRound(p2.y)),
+        Scalar(0, 255, 255), 2);
+
+    Scalar color = gesture == Gesture::Stop ? Scalar(0,0,255) : Scalar(0,255,0);
+    putText(out, gestureName(gesture), Point(20,60), FONT_HERSHEY_SIMPLEX, 0.8, color, 2);
+
+    // info; el desglose en % solo tiene sentido con los pesos fijos
+    const HandFeatures& f = features;
+    bool weighted = dynamic_cast<const WeightedClassifier*>(classifier.get()) != nullptr;
+    FistTerms t = fistTerms(f);
+    auto term = [&](double v) { return weighted ? " (" + to_string(int(v * 100)) + "%)" : string(); };
+
+    putText(out, "Angle: " + to_string(int(f.angle)),
+            Point(20, 90), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+
+    putText(out, "Solidity: " + to_string(f.solidity).substr(0,4) + term(t.solidity),
+            Point(20, 120), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+
+    putText(out, "Defects: " + to_string(int(f.defects)) + term(t.defects),
+            Point(20, 150), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+
+    putText(out, "Aspect: " + to_string(f.aspect).substr(0,4) + term(t.aspect),
+            Point(20, 180), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+
+    putText(out, "Result: " + to_string(f.fist) + " (" + classifier->name() + ")",
+            Point(20, 210), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255,150,0), 1);
+}
@@ -1,21 +1,133 @@
 #include "../../include/vision/gesture_recognition.h"
+#include <algorithm>
+#include <tuple>
 #include <vector>
 
+// rango HSV de piel por defecto
+static const Scalar SKIN_HSV_LOWER(0, 20, 70);
+static const Scalar SKIN_HSV_UPPER(20, 255, 255);
+
 VisionProcessor::VisionProcessor() {
-    solidity = 0; defects = 0; aspect = 0; angle = 0;
+    gesture = Gesture::None;
     handDetected = false;
+
+    workSize = Size(320, 240);
+    useRoi = true;
+    roiMargin = 0.5;
+    roiMinAreaRatio = 0.3;
+
+    // la tabla inicial reproduce el rango HSV, se reemplaza al calibrar
+    skinLut.buildFromHsvRange(SKIN_HSV_LOWER, SKIN_HSV_UPPER);
+    useSkinLut = true;
+
+    classifier = make_shared<WeightedClassifier>();
+
+    useTracking = true;
+    redetectInterval = 5;
+    minTrackRatio = 0.6;
+    lastFrameTracked = false;
+    framesSinceDetect = 0;
+    trackStartCount = 0;
+
+    useBackground = false;
+    useMomentOrientation = true;
+    useConnectedComponents = true;
+
+    maxHands = 1;
+    minHandAreaRatio = 0.25;
+    maxMissedFrames = 15;
+    nextHandId = 1;
 }
 
-void VisionProcessor::processHand(const Mat& inFrame) {
+void VisionProcessor::processHand(const Mat& inFrame, const Mat& grayFull) {
+    // la escala depende del frame completo, asi la ROI usa la misma resolucion
+    double scale = 1.0;
+    if (workSize.area() > 0) {
+        scale = min((double)workSize.width / inFrame.cols,
+                    (double)workSize.height / inFrame.rows);
+        scale = min(1.0, scale);
+    }
+
+    lastFrameTracked = false;
+    if (!useTracking && !useBackground) {
+        segmentHand(inFrame, Mat(), scale);
+        return;
+    }
+
+    // gris a resolucion de trabajo, compartido por el seguimiento y el fondo
+    Mat gray;
+    if (grayFull.empty()) cvtColor(inFrame, gray, COLOR_BGR2GRAY);
+    else gray = grayFull;
+    if (scale < 1.0) resize(gray, gray, Size(), scale, scale, INTER_AREA);
+    else if (!grayFull.empty()) gray = grayFull.clone();   // prevGray no debe compartir el buffer del llamador
+
+    if (useBackground) {
+        Rect handWork(cvRound(handBox.x * scale), cvRound(handBox.y * scale),
+                      cvRound(handBox.width * scale), cvRound(handBox.height * scale));
+        background.update(gray, handWork);
+    }
+
+    // con varias manos se segmenta siempre el frame completo
+    if (useTracking && maxHands <= 1 && trackHand(gray, scale)) {
+        lastFrameTracked = true;
+    } else {
+        segmentHand(inFrame, gray, scale);
+        if (useTracking) startTracking(scale);
+    }
+    prevGray = gray;
+}
 
-    // hsv
-    cvtColor(inFrame, hsv, COLOR_BGR2HSV);
+void VisionProcessor::segmentHand(const Mat& inFrame, const Mat& gray, double scale) {
+    Rect frameRect(0, 0, inFrame.cols, inFrame.rows);
+    if (!searchRegion.empty()) frameRect &= searchRegion;
+    if (frameRect.empty()) frameRect = Rect(0, 0, inFrame.cols, inFrame.rows);
+
+    // region a procesar: ventana alrededor de la mano anterior o zona de busqueda completa
+    Rect region = frameRect;
+    if (useRoi && maxHands <= 1 && !handBox.empty()) {
+        int dx = cvRound(handBox.width * roiMargin);
+        int dy = cvRound(handBox.height * roiMargin);
+        region = Rect(handBox.x - dx, handBox.y - dy,
+                      handBox.width + 2 * dx, handBox.height + 2 * dy) & frameRect;
+        if (region.empty()) region = frameRect;
+    }
+    // dentro de la ventana un blob mucho menor que la mano anterior es ruido:
+    // se vuelve a buscar en toda la zona en este mismo frame
+    const bool inRoi = region != frameRect;
+    auto tooSmall = [&](double workArea) {
+        return inRoi && workArea / (scale * scale) < roiMinAreaRatio * features.area;
+    };
 
-    Scalar lower(0, 20, 70);
-    Scalar upper(20, 255, 255);
+    Mat work;
+    if (scale < 1.0) resize(inFrame(region), work, Size(), scale, scale, INTER_AREA);
+    else work = inFrame(region);
 
     Mat mask;
-    inRange(hsv, lower, upper, mask);
+    if (useSkinLut && skinLut.ready()) {
+        skinLut.apply(work, mask);
+    } else {
+        // hsv
+        cvtColor(work, hsv, COLOR_BGR2HSV);
+        inRange(hsv, SKIN_HSV_LOWER, SKIN_HSV_UPPER, mask);
+    }
+
+    // zona excluida (p. ej. el marcador cuando hay una sola camara)
+    Rect excluded = excludeRegion & region;
+    if (!excluded.empty()) {
+        Rect ex(cvRound((excluded.x - region.x) * scale), cvRound((excluded.y - region.y) * scale),
+                cvRound(excluded.width * scale), cvRound(excluded.height * scale));
+        mask(ex & Rect(0, 0, mask.cols, mask.rows)).setTo(0);
+    }
+
+    // descartar piel del fondo estatico (muebles, caras quietas)
+    if (useBackground && background.ready() && !gray.empty()) {
+        Rect workRegion = Rect(cvRound(region.x * scale), cvRound(region.y * scale), work.cols, work.rows)
+                          & Rect(0, 0, gray.cols, gray.rows);
+        Mat fg;
+        background.foreground(gray, workRegion, fg);
+        if (fg.size() != mask.size()) resize(fg, fg, mask.size(), 0, 0, INTER_NEAREST);
+        bitwise_and(mask, fg, mask);
+    }
 
     // procesamiento previo
     GaussianBlur(mask, mask, Size(5, 5), 0);
@@ -23,17 +135,60 @@ void VisionProcessor::processHand(const Mat& inFrame) {
     erode(mask, mask, Mat(), Point(-1, -1), 2);
     dilate(mask, mask, Mat(), Point(-1, -1), 2);
 
-    vector<vector<Point>> contours;
-    findContours(mask, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+    stats.maskPixels = countNonZero(mask);
+
+    if (useConnectedComponents) {
+        // etiquetado en una pasada; el area de cada blob sale de las estadisticas
+        Mat labels, ccStats, centroids;
+        int n = connectedComponentsWithStats(mask, labels, ccStats, centroids, 8, CV_32S);
+        stats.blobs = n - 1;
+
+        // los maxHands blobs mas grandes, el primero es la mano principal
+        vector<int> order;
+        for (int i = 1; i < n; i++) order.push_back(i);
+        size_t keep = min(order.size(), (size_t)max(1, maxHands));
+        partial_sort(order.begin(), order.begin() + keep, order.end(), [&](int a, int b) {
+            return ccStats.at<int>(a, CC_STAT_AREA) > ccStats.at<int>(b, CC_STAT_AREA);
+        });
+        order.resize(keep);
+        if (!order.empty() && tooSmall(ccStats.at<int>(order[0], CC_STAT_AREA))) {
+            handBox = Rect();
+            segmentHand(inFrame, gray, scale);
+            return;
+        }
 
-    outFrame = inFrame.clone();
+        // descartar blobs chicos frente a la mano principal
+        while (order.size() > 1 &&
+               ccStats.at<int>(order.back(), CC_STAT_AREA) < minHandAreaRatio * ccStats.at<int>(order[0], CC_STAT_AREA))
+            order.pop_back();
+
+        // cada mano se traza y se mide en paralelo
+        vector<HandDetection> found(order.size());
+        parallel_for_(Range(0, (int)order.size()), [&](const Range& r) {
+            for (int k = r.start; k < r.end; k++)
+                found[k] = traceBlob(labels, ccStats, order[k], region, scale);
+        });
+        if (maxHands > 1) updateHands(found, inFrame.size());
+
+        if (found.empty() || found[0].contour.empty()) {
+            loseHand();
+            return;
+        }
 
-    if (contours.empty()) {
-        putText(outFrame, "No hand detected", Point(20, 30), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0, 0, 255), 2);
+        contour.swap(found[0].contour);
+        hull.swap(found[0].hull);
+        fittingLine = found[0].line;
+        features = found[0].features;
+        handBox = features.box;
         return;
     }
 
-    int maxIdx = 0;
+    // camino clasico: contourArea sobre todos los contornos
+    vector<vector<Point>> contours;
+    findContours(mask, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+    stats.blobs = (int)contours.size();
+
+    int maxIdx = -1;
     double maxArea = 0;
     for (int i = 0; i < contours.size(); i++) {
 
@@ -44,173 +199,278 @@ void VisionProcessor::processHand(const Mat& inFrame) {
         }
     }
 
-    contour = contours[maxIdx];
-    drawContours(outFrame, contours, (int)maxIdx, Scalar(0, 255, 0), 2);
-
-    // procesamiento de convex hull
-    convexHull(contour, hull);
-    polylines(outFrame, hull, true, Scalar(255, 0, 0), 2);
-
-    // procesamiento de fitting line
-    fitLine(contour, fittingLine, DIST_L2, 0, 0.01, 0.01);
-    Point2f pointOnLine(fittingLine[2], fittingLine[3]);
-    Point2f direction(fittingLine[0], fittingLine[1]);
-
-    float length = 200.0f;
-    Point2f p1 = pointOnLine - direction * length;
-    Point2f p2 = pointOnLine + direction * length;
- 
-    line(outFrame, 
-        Point(cvRound(p1.x), cvRound(p1.y)),
-        Point(cvRound(p2.x), cvRound(p2.y)),
-        Scalar(0, 255, 255), 2);
+    if (maxIdx < 0) {
+        loseHand();
+        return;
+    }
+    if (tooSmall(maxArea)) {
+        handBox = Rect();
+        segmentHand(inFrame, gray, scale);
+        return;
+    }
 
-    //this->classifyHand();
-}
+    // blob de la mano en coordenadas de trabajo (relativas a la region)
+    const vector<Point>& blobContour = contours[maxIdx];
+    Rect box = boundingRect(blobContour);
+    BlobMoments m;
+    if (useMomentOrientation) {
+        // solo los pixeles de este blob: otros blobs pueden entrar en su bounding box
+        Mat blob = Mat::zeros(box.size(), CV_8UC1);
+        drawContours(blob, contours, maxIdx, Scalar(255), FILLED, LINE_8, noArray(), 0, -box.tl());
+        bitwise_and(blob, mask(box), blob);
+        for (int y = 0; y < box.height; y++)
+            m.addRow(blob.ptr<uchar>(y), box.width, y);
+    }
 
-double VisionProcessor::calculateSolidity() const {
-    // no hay nada
-    if (hull.empty()) return 0.0; 
+    // contorno de vuelta a coordenadas del frame original
+    contour.resize(blobContour.size());
+    for (size_t i = 0; i < contour.size(); i++) {
+        const Point& p = blobContour[i];
+        contour[i] = Point(cvRound(p.x / scale) + region.x, cvRound(p.y / scale) + region.y);
+    }
 
-    double areaHull = contourArea(hull);
-    double areaContour = contourArea(contour);
+    if (useMomentOrientation) {
+        // eje principal con los momentos del blob
+        Point2f offset(region.x + box.x / scale, region.y + box.y / scale);
+        fittingLine = orientationLine(m, offset, scale);
+    } else {
+        // procesamiento de fitting line
+        fitLine(contour, fittingLine, DIST_L2, 0, 0.01, 0.01);
+    }
 
-    return areaContour / areaHull;
+    // convex hull, areas, defectos y orientacion en una sola pasada
+    updateFeatures();
 }
 
-double VisionProcessor::calculateAngle() const {
-    if (fittingLine == Vec4f()) return 0.0;
-
-    double angleRad = atan2(fittingLine[1], fittingLine[0]);
-    double angleDeg = angleRad * 180.0f / CV_PI;
-    return angleDeg;
+void VisionProcessor::loseHand() {
+    // mano perdida: el siguiente frame vuelve a buscar en el frame completo
+    contour.clear();
+    hull.clear();
+    fittingLine = Vec4f();
+    features = HandFeatures();
+    handBox = Rect();
 }
 
-double VisionProcessor::calculateAspect() const{
-    if (contour.empty()) return 0.0;
+HandDetection VisionProcessor::traceBlob(const Mat& labels, const Mat& ccStats, int label,
+                                         const Rect& region, double scale) const {
+    HandDetection d;
+    Rect box(ccStats.at<int>(label, CC_STAT_LEFT), ccStats.at<int>(label, CC_STAT_TOP),
+             ccStats.at<int>(label, CC_STAT_WIDTH), ccStats.at<int>(label, CC_STAT_HEIGHT));
+
+    // mascara del blob y momentos en la misma pasada sobre su bounding box
+    BlobMoments m;
+    Mat blob(box.size(), CV_8UC1);
+    for (int y = 0; y < box.height; y++) {
+        const int* lbl = labels.ptr<int>(box.y + y) + box.x;
+        uchar* dst = blob.ptr<uchar>(y);
+        for (int x = 0; x < box.width; x++) dst[x] = lbl[x] == label ? 255 : 0;
+        if (useMomentOrientation) m.addRow(dst, box.width, y);
+    }
 
-    Rect bound = boundingRect(contour);
+    // solo se traza el contorno del blob elegido
+    vector<vector<Point>> contours;
+    findContours(blob, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE, box.tl());
+    if (contours.empty()) return d;
+
+    size_t longest = 0;
+    for (size_t i = 0; i < contours.size(); i++)
+        if (contours[i].size() > contours[longest].size()) longest = i;
+
+    // contorno de vuelta a coordenadas del frame original
+    const vector<Point>& c = contours[longest];
+    d.contour.resize(c.size());
+    for (size_t i = 0; i < c.size(); i++)
+        d.contour[i] = Point(cvRound(c[i].x / scale) + region.x, cvRound(c[i].y / scale) + region.y);
+
+    if (useMomentOrientation) {
+        Point2f offset(region.x + box.x / scale, region.y + box.y / scale);
+        d.line = orientationLine(m, offset, scale);
+    } else {
+        fitLine(d.contour, d.line, DIST_L2, 0, 0.01, 0.01);
+    }
 
-    return bound.width / bound.height;
-    // cuadrado = 1, rectangulo < 1
+    d.features = extractHandFeatures(d.contour, d.line, d.hull);
+    d.features.fist = classifier->fistProbability(d.features);
+    return d;
 }
 
-double VisionProcessor::calculateDefects() const {
-
-    if (contour.empty() || hull.empty()) return 0.0;
-
-    // indices del hull
-    vector<int> hullIndices;
-    convexHull(contour, hullIndices, false, false);
-
-    // calcular defectos
-    vector<Vec4i> defects;
-    convexityDefects(contour, hullIndices, defects);
+void VisionProcessor::updateHands(const vector<HandDetection>& found, Size frameSize) {
+    const double maxDist = 0.25 * frameSize.width;
+
+    auto center = [](const HandFeatures& f) {
+        return Point2f(f.box.x + f.box.width * 0.5f, f.box.y + f.box.height * 0.5f);
+    };
+
+    // emparejamiento voraz por distancia entre centros; las manos perdidas
+    // compiten con su ultimo centro visto, asi no intercambian IDs al volver
+    vector<tuple<double, int, int>> pairs;
+    for (int h = 0; h < (int)hands.size(); h++)
+        for (int d = 0; d < (int)found.size(); d++) {
+            if (found[d].contour.empty()) continue;
+            double dist = norm(hands[h].lastCenter - center(found[d].features));
+            if (dist < maxDist) pairs.emplace_back(dist, h, d);
+        }
+    sort(pairs.begin(), pairs.end());
+
+    vector<bool> handUsed(hands.size(), false), foundUsed(found.size(), false);
+    for (const auto& p : pairs) {
+        int h = get<1>(p), d = get<2>(p);
+        if (handUsed[h] || foundUsed[d]) continue;
+        handUsed[h] = foundUsed[d] = true;
+        hands[h].det = found[d];
+        hands[h].lastCenter = center(found[d].features);
+        hands[h].missed = 0;
+    }
 
-    return defects.size();
-}
+    // manos sin pareja: se marcan perdidas
+    for (size_t h = 0; h < hands.size(); h++) {
+        if (handUsed[h]) continue;
+        hands[h].det = HandDetection();
+        hands[h].missed++;
+    }
 
-void VisionProcessor::classifyHand() {
-    double solidity = calculateSolidity(); // avanzar si < 90
-    double aspect = calculateAspect(); // solo detecta el puño, pero tambien devuelve 1 si es que la mano esta muy abierta, error
-    double defects = calculateDefects(); // a veces es puño cuando los defectos son mayores a 31
-    double angle = calculateAngle();
-
-    double result = 0.0;
-
-    double solidityCont = min(1.0, max(0.0, (solidity - 0.85) / (1.0 - 0.85)));
-    double defectsCont = 1.0 - min(1.0, defects / 10.0);
-    double aspectCont = aspect;  // Ahora aspect está en [0,1]
-
-    // Pesos ajustados (mayor peso a solidity)
-    const double SOLIDITY_WEIGHT = 0.7;
-    const double DEFECTS_WEIGHT = 0.2;
-    const double ASPECT_WEIGHT = 0.1;
-
-    result = (solidityCont * SOLIDITY_WEIGHT) + 
-            (defectsCont * DEFECTS_WEIGHT) + 
-            (aspectCont * ASPECT_WEIGHT);
-
-    const double FIST_THRESHOLD = 0.5;
-    bool isFist = (result >= FIST_THRESHOLD);
-
-    const int var1 = 50, var2 = 90;
-    
-    if (isFist) {
-        putText(outFrame, "STOP", Point(20,60), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0,0,255), 2);
-    }
-    else {
-        if ((angle > var1 && angle < var2) || (angle > -var2 && angle < -var1)) {
-            putText(outFrame, "ADVANCE (W)", Point(20,60), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0,255,0), 2);
-        } 
-        else if (angle > 0 && angle <= var1) {
-            putText(outFrame, "ADVANCE LEFT (A)", Point(20,60), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0,255,200), 2);
-        } 
-        else if (angle > -var1 && angle <= 0) {
-            putText(outFrame, "ADVANCE RIGHT (D)", Point(20,60), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(200,255,0), 2);
+    // detecciones nuevas: ranura de jugador libre o la mano perdida mas cercana
+    for (size_t d = 0; d < found.size(); d++) {
+        if (foundUsed[d] || found[d].contour.empty()) continue;
+        Point2f c = center(found[d].features);
+
+        vector<bool> taken(max(1, maxHands), false);
+        for (const auto& h : hands)
+            if (h.player < (int)taken.size()) taken[h.player] = true;
+        int slot = (int)(find(taken.begin(), taken.end(), false) - taken.begin());
+
+        if (slot < (int)taken.size()) {
+            TrackedHand h;
+            h.id = nextHandId++;
+            h.player = slot;
+            h.det = found[d];
+            h.lastCenter = c;
+            h.tracker = make_shared<GestureTracker>();
+            hands.push_back(h);
+            handUsed.push_back(true);
+        } else {
+            TrackedHand* nearest = nullptr;
+            for (size_t h = 0; h < hands.size(); h++) {
+                if (hands[h].missed == 0 || handUsed[h]) continue;
+                if (!nearest || norm(hands[h].lastCenter - c) < norm(nearest->lastCenter - c))
+                    nearest = &hands[h];
+            }
+            if (!nearest) continue;
+            nearest->det = found[d];
+            nearest->lastCenter = c;
+            nearest->missed = 0;
+            handUsed[nearest - hands.data()] = true;
         }
     }
 
-    // info
-    putText(outFrame, "Angle: " + to_string(int(angle)), 
-            Point(20, 90), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+    hands.erase(remove_if(hands.begin(), hands.end(), [&](const TrackedHand& h) {
+        return h.missed > maxMissedFrames;
+    }), hands.end());
+}
 
-    putText(outFrame, "Solidity: " + to_string(solidity).substr(0,4) + 
-           " (" + to_string(int(solidityCont*100)) + "%)", 
-            Point(20, 120), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+void VisionProcessor::updateFeatures() {
+    features = extractHandFeatures(contour, fittingLine, hull);
+    features.fist = classifier->fistProbability(features);
+    handBox = features.box;
+}
 
-    putText(outFrame, "Defects: " + to_string(defects) + 
-           " (" + to_string(int(defectsCont*100)) + "%)", 
-            Point(20, 150), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+void VisionProcessor::startTracking(double scale) {
+    trackPts.clear();
+    framesSinceDetect = 0;
+    if (contour.empty()) return;
+
+    // puntos del hull (esquinas, dedos) mas una muestra del contorno
+    const size_t maxContourPts = 40;
+    size_t stride = max<size_t>(1, contour.size() / maxContourPts);
+    for (const Point& p : hull)
+        trackPts.push_back(Point2f(p.x * scale, p.y * scale));
+    for (size_t i = 0; i < contour.size(); i += stride)
+        trackPts.push_back(Point2f(contour[i].x * scale, contour[i].y * scale));
+    trackStartCount = trackPts.size();
+}
 
-    putText(outFrame, "Aspect: " + to_string(aspect).substr(0,4) + 
-           " (" + to_string(int(aspectCont*100)) + "%)", 
-            Point(20, 180), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(200,200,0), 1);
+bool VisionProcessor::trackHand(const Mat& gray, double scale) {
+    if (trackPts.size() < 4 || prevGray.empty() || prevGray.size() != gray.size()) return false;
+    if (++framesSinceDetect >= redetectInterval) return false;
 
-    putText(outFrame, "Result: " + to_string(result), 
-            Point(20, 210), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255,150,0), 1);
+    vector<Point2f> next;
+    vector<uchar> status;
+    vector<float> err;
+    calcOpticalFlowPyrLK(prevGray, gray, trackPts, next, status, err, Size(15, 15), 2);
 
+    vector<Point2f> from, to;
+    for (size_t i = 0; i < trackPts.size(); i++) {
+        if (!status[i]) continue;
+        from.push_back(trackPts[i]);
+        to.push_back(next[i]);
+    }
+    // contra los puntos de la ultima segmentacion: la perdida no se acumula frame a frame
+    if (from.size() < 4 || from.size() < minTrackRatio * trackStartCount) return false;
+
+    // movimiento rigido de la mano (rotacion + escala + traslacion)
+    vector<uchar> inliers;
+    Mat T = estimateAffinePartial2D(from, to, inliers, RANSAC, 2.0);
+    if (T.empty()) return false;
+
+    int good = countNonZero(inliers);
+    if (good < minTrackRatio * trackStartCount) return false;
+
+    // misma transformacion en coordenadas del frame original
+    Matx23d A = T;
+    A(0, 2) /= scale;
+    A(1, 2) /= scale;
+
+    vector<Point2f> pts(contour.begin(), contour.end()), moved;
+    cv::transform(pts, moved, A);
+    for (size_t i = 0; i < contour.size(); i++)
+        contour[i] = Point(cvRound(moved[i].x), cvRound(moved[i].y));
+
+    // linea de ajuste: se rota la direccion y se mueve el punto
+    Point2f dir(A(0, 0) * fittingLine[0] + A(0, 1) * fittingLine[1],
+                A(1, 0) * fittingLine[0] + A(1, 1) * fittingLine[1]);
+    double len = norm(dir);
+    if (len <= 0) return false;
+    dir *= 1.0 / len;
+    if (dir.x < 0) dir = -dir;   // mismo rango de angulo que fitLine
+    Point2f p(A(0, 0) * fittingLine[2] + A(0, 1) * fittingLine[3] + A(0, 2),
+              A(1, 0) * fittingLine[2] + A(1, 1) * fittingLine[3] + A(1, 2));
+    fittingLine = Vec4f(dir.x, dir.y, p.x, p.y);
+
+    trackPts.clear();
+    for (size_t i = 0; i < to.size(); i++)
+        if (inliers[i]) trackPts.push_back(to[i]);
+
+    updateFeatures();
+    return true;
 }
 
-void VisionProcessor::update() {
-    handDetected = !contour.empty() && !hull.empty();
-    if (!handDetected) return;
+void VisionProcessor::update(chrono::steady_clock::time_point t) {
+    handDetected = features.detected;
+    gesture = classifyGesture(features);
+    tracker.update(features, t);
 
-    solidity = calculateSolidity();
-    defects = calculateDefects();
-    aspect = calculateAspect();
-    angle = calculateAngle();
+    for (auto& h : hands)
+        h.tracker->update(h.det.features, t);
 }
 
-bool VisionProcessor::isStop() const {
-    if (!handDetected) return false;
-
-    double solidityCont = min(1.0, max(0.0, (solidity - 0.85) / (1.0 - 0.85)));
-    double defectsCont = 1.0 - min(1.0, defects / 10.0);
-    double aspectCont = aspect;
-
-    double result = (solidityCont * 0.7) + (defectsCont * 0.2) + (aspectCont * 0.1);
+const TrackedHand* VisionProcessor::handForPlayer(int player) const {
+    for (const auto& h : hands)
+        if (h.player == player) return &h;
+    return nullptr;
+}
 
-    return result >= 0.5;
+bool VisionProcessor::isStop() const {
+    return gesture == Gesture::Stop;
 }
 
 bool VisionProcessor::isAdvance() const {
-    if (!handDetected || isStop()) return false;
-    int var1 = 50, var2 = 90;
-
-    return ( (angle > var1 && angle < var2) || (angle > -var2 && angle < -var1) );
+    return gesture == Gesture::Advance;
 }
 
 bool VisionProcessor::isLeft() const {
-    if (!handDetected || isStop()) return false;
-    int var = 50;
-
-    return (angle > 0 && angle <= var);
+    return gesture == Gesture::Left;
 }
 
 bool VisionProcessor::isRight() const {
-    if (!handDetected || isStop()) return false;
-    int var = 50;
-
-    return (angle > -var && angle <= 0);
+    return gesture == Gesture::Right;
 }
@@ -0,0 +1,81 @@
+#include "../../include/vision/gesture_tracker.h"
+
+namespace {
+const size_t MAX_EVENTS = 32;
+
+double clamp01(double v) { return min(1.0, max(0.0, v)); }
+
+// confianza segun la distancia del rasgo al borde de la region del gesto
+double gestureConfidence(const HandFeatures& f, Gesture g) {
+    if (!f.detected) return 1.0;
+
+    double score = f.fist;
+    if (g == Gesture::Stop) return clamp01(0.5 + (score - FIST_THRESHOLD) * 2.0);
+    if (g == Gesture::None) return 0.5;
+
+    double a = f.angle, inside = 0.0;
+    if (g == Gesture::Advance) {
+        double aa = fabs(a);
+        inside = min(aa - ADVANCE_MIN_ANGLE, ADVANCE_MAX_ANGLE - aa);
+    } else if (g == Gesture::Left) {
+        inside = min(a, ADVANCE_MIN_ANGLE - a);
+    } else {
+        inside = min(-a, ADVANCE_MIN_ANGLE + a);
+    }
+
+    double angleConf = clamp01(0.5 + inside / 30.0);
+    double scoreConf = clamp01(0.5 + (FIST_THRESHOLD - score) * 2.0);
+    return min(angleConf, scoreConf);
+}
+}
+
+GestureTracker::GestureTracker() {
+    angleMargin = 8.0;
+    scoreMargin = 0.08;
+    minDwell = chrono::milliseconds(120);
+    lostTimeout = chrono::milliseconds(300);
+    stable = candidate = Gesture::None;
+}
+
+void GestureTracker::update(const HandFeatures& f, TimePoint t) {
+    // el gesto actual se mantiene mientras siga dentro de su banda ensanchada
+    Gesture raw;
+    if (stable != Gesture::None && matchesGesture(f, stable, angleMargin, scoreMargin))
+        raw = stable;
+    else
+        raw = classifyGesture(f);
+
+    if (raw == stable) {
+        candidate = stable;
+        return;
+    }
+    if (raw != candidate) {
+        candidate = raw;
+        candidateSince = t;
+    }
+
+    auto dwell = raw == Gesture::None ? lostTimeout : minDwell;
+    if (t - candidateSince < dwell) return;
+
+    stable = raw;
+
+    GestureEvent ev;
+    ev.gesture = stable;
+    ev.confidence = gestureConfidence(f, stable);
+    ev.time = t;
+
+    if (events.size() >= MAX_EVENTS) events.pop_front();
+    events.push_back(ev);
+}
+
+bool GestureTracker::poll(GestureEvent& ev) {
+    if (events.empty()) return false;
+    ev = events.front();
+    events.pop_front();
+    return true;
+}
+
+void GestureTracker::reset() {
+    stable = candidate = Gesture::None;
+    events.clear();
+}
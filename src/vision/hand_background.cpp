@@ -0,0 +1,44 @@
+#include "../../include/vision/hand_background.h"
+
+HandBackground::HandBackground() {
+    learningRate = 0.05;
+    updateInterval = 10;
+    threshold = 25;
+    frameCount = 0;
+}
+
+void HandBackground::update(const Mat& gray, const Rect& exclude) {
+    if (background.empty() || background.size() != gray.size()) {
+        gray.convertTo(background, CV_32F);
+        gray.copyTo(background8u);
+        frameCount = 0;
+        return;
+    }
+
+    // baja frecuencia: solo cada updateInterval frames
+    if (++frameCount < updateInterval) return;
+    frameCount = 0;
+
+    Mat learnMask;
+    if (!exclude.empty()) {
+        learnMask = Mat(gray.size(), CV_8UC1, Scalar(255));
+        learnMask(exclude & Rect(0, 0, gray.cols, gray.rows)).setTo(0);
+    }
+    accumulateWeighted(gray, background, learningRate, learnMask);
+    background.convertTo(background8u, CV_8U);
+}
+
+void HandBackground::foreground(const Mat& gray, const Rect& region, Mat& fg) const {
+    CV_Assert(ready() && gray.size() == background8u.size());
+
+    absdiff(gray(region), background8u(region), fg);
+    cv::threshold(fg, fg, threshold, 255, THRESH_BINARY);
+    // margen para no recortar los bordes de la mano
+    dilate(fg, fg, Mat(), Point(-1, -1), 1);
+}
+
+void HandBackground::reset() {
+    background.release();
+    background8u.release();
+    frameCount = 0;
+}
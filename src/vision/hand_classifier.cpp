@@ -0,0 +1,155 @@
+#include "../../include/vision/hand_classifier.h"
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+HandFeatureVec toFeatureVec(const HandFeatures& f) {
+    double boxArea = max(1, f.box.area());
+    return HandFeatureVec((float)f.solidity, (float)f.defects, (float)f.aspect, (float)(f.area / boxArea));
+}
+
+LogisticClassifier::LogisticClassifier() {
+    mean = HandFeatureVec::all(0.0f);
+    scale = HandFeatureVec::all(1.0f);
+    weights = HandFeatureVec::all(0.0f);
+}
+
+double LogisticClassifier::fistProbability(const HandFeatures& f) const {
+    return probability(toFeatureVec(f));
+}
+
+double LogisticClassifier::probability(const HandFeatureVec& x) const {
+    float z = bias;
+    for (int i = 0; i < HAND_FEATURE_COUNT; i++)
+        z += weights[i] * (x[i] - mean[i]) * scale[i];
+    return 1.0 / (1.0 + exp(-z));
+}
+
+void LogisticClassifier::train(const vector<HandFeatureVec>& X, const vector<int>& labels,
+                               int iterations, float learningRate, float l2) {
+    const size_t n = X.size();
+    if (n == 0) return;
+
+    // estandarizacion
+    mean = HandFeatureVec::all(0.0f);
+    for (const auto& x : X) mean += x;
+    mean *= 1.0f / n;
+
+    HandFeatureVec var = HandFeatureVec::all(0.0f);
+    for (const auto& x : X)
+        for (int i = 0; i < HAND_FEATURE_COUNT; i++)
+            var[i] += (x[i] - mean[i]) * (x[i] - mean[i]);
+    for (int i = 0; i < HAND_FEATURE_COUNT; i++)
+        scale[i] = var[i] > 0 ? 1.0f / sqrt(var[i] / n) : 1.0f;
+
+    weights = HandFeatureVec::all(0.0f);
+    bias = 0.0f;
+
+    for (int it = 0; it < iterations; it++) {
+        HandFeatureVec grad = HandFeatureVec::all(0.0f);
+        float gradBias = 0.0f;
+
+        for (size_t k = 0; k < n; k++) {
+            float err = (float)probability(X[k]) - labels[k];
+            for (int i = 0; i < HAND_FEATURE_COUNT; i++)
+                grad[i] += err * (X[k][i] - mean[i]) * scale[i];
+            gradBias += err;
+        }
+
+        for (int i = 0; i < HAND_FEATURE_COUNT; i++)
+            weights[i] -= learningRate * (grad[i] / n + l2 * weights[i]);
+        bias -= learningRate * gradBias / n;
+    }
+}
+
+bool LogisticClassifier::save(const string& path) const {
+    FileStorage fs(path, FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+
+    fs << "type" << "logistic";
+    fs << "mean" << Mat(mean);
+    fs << "scale" << Mat(scale);
+    fs << "weights" << Mat(weights);
+    fs << "bias" << bias;
+    return true;
+}
+
+bool LogisticClassifier::load(const string& path) {
+    FileStorage fs(path, FileStorage::READ);
+    if (!fs.isOpened() || (string)fs["type"] != "logistic") return false;
+
+    Mat m, s, w;
+    fs["mean"] >> m;
+    fs["scale"] >> s;
+    fs["weights"] >> w;
+    if (m.total() != HAND_FEATURE_COUNT || s.total() != HAND_FEATURE_COUNT || w.total() != HAND_FEATURE_COUNT) {
+        cerr << "Modelo de mano invalido: " << path << "\n";
+        return false;
+    }
+
+    for (int i = 0; i < HAND_FEATURE_COUNT; i++) {
+        mean[i] = m.at<float>(i);
+        scale[i] = s.at<float>(i);
+        weights[i] = w.at<float>(i);
+    }
+    fs["bias"] >> bias;
+    return true;
+}
+
+shared_ptr<HandClassifier> loadHandClassifier(const string& path) {
+    auto logistic = make_shared<LogisticClassifier>();
+    if (logistic->load(path)) {
+        cout << "Clasificador de mano cargado: " << path << "\n";
+        return logistic;
+    }
+    return make_shared<WeightedClassifier>();
+}
+
+bool appendFeatureCsv(const string& path, const HandFeatures& f, int label) {
+    if (!f.detected) return false;
+
+    ofstream out(path, ios::app);
+    if (!out) return false;
+
+    HandFeatureVec x = toFeatureVec(f);
+    out << x[0] << "," << x[1] << "," << x[2] << "," << x[3] << "," << f.angle << "," << label << "\n";
+    return true;
+}
+
+bool readFeatureCsv(const string& path, vector<HandFeatureVec>& X, vector<int>& labels) {
+    ifstream in(path);
+    if (!in) return false;
+
+    string row;
+    size_t skipped = 0;
+    while (getline(in, row)) {
+        if (!row.empty() && row.back() == '\r') row.pop_back();
+        if (row.empty() || !(isdigit((unsigned char)row[0]) || row[0] == '-' || row[0] == '.')) continue;  // cabecera
+
+        // celdas vacias o a medio escribir (muestreo cortado) descartan la fila
+        stringstream ss(row);
+        string cell;
+        vector<float> values;
+        bool valid = true;
+        while (valid && getline(ss, cell, ',')) {
+            char* end = nullptr;
+            float v = strtof(cell.c_str(), &end);
+            valid = end != cell.c_str() && *end == '\0' && isfinite(v);
+            values.push_back(v);
+        }
+        if (!valid || values.size() < HAND_FEATURE_COUNT + 2) {
+            skipped++;
+            continue;
+        }
+
+        HandFeatureVec x;
+        for (int i = 0; i < HAND_FEATURE_COUNT; i++) x[i] = values[i];
+        X.push_back(x);
+        labels.push_back(values.back() > 0.5f ? 1 : 0);
+    }
+    if (skipped > 0) cerr << path << ": " << skipped << " filas invalidas descartadas\n";
+    return true;
+}
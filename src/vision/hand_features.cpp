@@ -0,0 +1,106 @@
+#include "../../include/vision/hand_features.h"
+
+void BlobMoments::addRow(const uchar* row, int cols, int y) {
+    double n = 0, sx = 0, sxx = 0;
+    for (int x = 0; x < cols; x++) {
+        if (!row[x]) continue;
+        n += 1; sx += x; sxx += (double)x * x;
+    }
+    m00 += n; m10 += sx; m01 += n * y;
+    m20 += sxx; m11 += sx * y; m02 += n * y * y;
+}
+
+Vec4f orientationLine(const BlobMoments& m, Point2f offset, double scale) {
+    if (m.m00 <= 0) return Vec4f();
+
+    double cx = m.m10 / m.m00, cy = m.m01 / m.m00;
+    double mu20 = m.m20 / m.m00 - cx * cx;
+    double mu02 = m.m02 / m.m00 - cy * cy;
+    double mu11 = m.m11 / m.m00 - cx * cy;
+
+    // mismo rango que fitLine: theta en (-90, 90], vx >= 0
+    double theta = 0.5 * atan2(2.0 * mu11, mu20 - mu02);
+    return Vec4f((float)cos(theta), (float)sin(theta),
+                 (float)(cx / scale + offset.x), (float)(cy / scale + offset.y));
+}
+
+HandFeatures extractHandFeatures(const vector<Point>& contour, const Vec4f& line, vector<Point>& hull) {
+    HandFeatures f;
+    hull.clear();
+    if (contour.size() < 3) return f;
+
+    // indices del hull, se reutilizan para los defectos
+    vector<int> hullIndices;
+    convexHull(contour, hullIndices, false, false);
+    hull.reserve(hullIndices.size());
+    for (int idx : hullIndices) hull.push_back(contour[idx]);
+
+    f.area = contourArea(contour);
+    f.hullArea = contourArea(hull);
+    f.solidity = f.hullArea > 0 ? f.area / f.hullArea : 0.0;
+
+    if (hullIndices.size() > 3) {
+        vector<Vec4i> defects;
+        convexityDefects(contour, hullIndices, defects);
+        f.defects = (double)defects.size();
+    }
+
+    f.box = boundingRect(contour);
+    f.aspect = (double)min(f.box.width, f.box.height) / max(1, max(f.box.width, f.box.height));
+
+    if (line != Vec4f())
+        f.angle = atan2(line[1], line[0]) * 180.0 / CV_PI;
+
+    f.detected = true;
+    return f;
+}
+
+FistTerms fistTerms(const HandFeatures& f) {
+    FistTerms t;
+    t.solidity = min(1.0, max(0.0, (f.solidity - 0.85) / (1.0 - 0.85)));
+    t.defects = 1.0 - min(1.0, f.defects / 10.0);
+    t.aspect = f.aspect;
+    return t;
+}
+
+double fistScore(const HandFeatures& f) {
+    FistTerms t = fistTerms(f);
+    return t.solidity * FIST_SOLIDITY_WEIGHT + t.defects * FIST_DEFECTS_WEIGHT + t.aspect * FIST_ASPECT_WEIGHT;
+}
+
+bool matchesGesture(const HandFeatures& f, Gesture g, double angleMargin, double scoreMargin) {
+    if (!f.detected) return g == Gesture::None;
+
+    double score = f.fist;
+    if (g == Gesture::Stop) return score >= FIST_THRESHOLD - scoreMargin;
+    if (score >= FIST_THRESHOLD + scoreMargin) return false;
+
+    const double a = f.angle, m = angleMargin;
+    const double var1 = ADVANCE_MIN_ANGLE, var2 = ADVANCE_MAX_ANGLE;
+
+    switch (g) {
+    case Gesture::Advance: return (a > var1 - m && a < var2 + m) || (a > -var2 - m && a < -var1 + m);
+    case Gesture::Left:    return a > 0 - m && a <= var1 + m;
+    case Gesture::Right:   return a > -var1 - m && a <= 0 + m;
+    default:               return false;
+    }
+}
+
+Gesture classifyGesture(const HandFeatures& f) {
+    if (!f.detected) return Gesture::None;
+
+    const Gesture order[] = { Gesture::Stop, Gesture::Advance, Gesture::Left, Gesture::Right };
+    for (Gesture g : order)
+        if (matchesGesture(f, g)) return g;
+    return Gesture::None;
+}
+
+const char* gestureName(Gesture g) {
+    switch (g) {
+    case Gesture::Stop:    return "STOP";
+    case Gesture::Advance: return "ADVANCE (W)";
+    case Gesture::Left:    return "ADVANCE LEFT (A)";
+    case Gesture::Right:   return "ADVANCE RIGHT (D)";
+    default:               return "NONE";
+    }
+}
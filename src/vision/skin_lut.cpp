@@ -0,0 +1,176 @@
+#include "../../include/vision/skin_lut.h"
+#include <iostream>
+
+namespace {
+// suavizado [1 2 1] en cada eje del histograma 3D
+vector<float> smoothHistogram(const vector<float>& in) {
+    const int n = SkinLut::BINS;
+    const int strides[3] = { n * n, n, 1 };
+
+    vector<float> cur = in, tmp(in.size());
+    for (int axis = 0; axis < 3; axis++) {
+        int st = strides[axis];
+        for (int i = 0; i < SkinLut::SIZE; i++) {
+            int c = (i / st) % n;
+            float prev = c > 0 ? cur[i - st] : cur[i];
+            float next = c < n - 1 ? cur[i + st] : cur[i];
+            tmp[i] = 0.25f * prev + 0.5f * cur[i] + 0.25f * next;
+        }
+        swap(cur, tmp);
+    }
+    return cur;
+}
+}
+
+SkinLut::SkinLut() {
+    threshold = 128;
+    skinCount.assign(SIZE, 0.0f);
+    backCount.assign(SIZE, 0.0f);
+}
+
+void SkinLut::buildFromHsvRange(const Scalar& lower, const Scalar& upper) {
+    const int step = 256 / BINS;
+
+    // un color por bin (centro del bin)
+    Mat colors(SIZE, 1, CV_8UC3);
+    for (int b = 0; b < BINS; b++)
+        for (int g = 0; g < BINS; g++)
+            for (int r = 0; r < BINS; r++) {
+                int i = (b << (2 * BITS)) | (g << BITS) | r;
+                colors.at<Vec3b>(i) = Vec3b(b * step + step / 2, g * step + step / 2, r * step + step / 2);
+            }
+
+    Mat hsv, in;
+    cvtColor(colors, hsv, COLOR_BGR2HSV);
+    inRange(hsv, lower, upper, in);
+
+    prob.assign(in.ptr<uchar>(), in.ptr<uchar>() + SIZE);
+    updateBinary();
+}
+
+void SkinLut::addSamples(const Mat& bgr, const Mat& skinMask) {
+    CV_Assert(bgr.type() == CV_8UC3 && skinMask.type() == CV_8UC1 && bgr.size() == skinMask.size());
+
+    for (int y = 0; y < bgr.rows; y++) {
+        const uchar* src = bgr.ptr<uchar>(y);
+        const uchar* lbl = skinMask.ptr<uchar>(y);
+        for (int x = 0; x < bgr.cols; x++, src += 3) {
+            int i = index(src[0], src[1], src[2]);
+            if (lbl[x]) skinCount[i] += 1.0f;
+            else backCount[i] += 1.0f;
+        }
+    }
+}
+
+void SkinLut::addCalibrationRoi(const Mat& bgr, const Rect& roi) {
+    Mat label = Mat::zeros(bgr.size(), CV_8UC1);
+    label(roi & Rect(0, 0, bgr.cols, bgr.rows)).setTo(255);
+    addSamples(bgr, label);
+}
+
+void SkinLut::build() {
+    double totalSkin = 0, totalBack = 0;
+    for (int i = 0; i < SIZE; i++) {
+        totalSkin += skinCount[i];
+        totalBack += backCount[i];
+    }
+    if (totalSkin == 0) {
+        cerr << "SkinLut: no hay muestras de piel\n";
+        return;
+    }
+
+    vector<float> skin = smoothHistogram(skinCount);
+    vector<float> back = smoothHistogram(backCount);
+
+    prob.resize(SIZE);
+    for (int i = 0; i < SIZE; i++) {
+        double ps = skin[i] / totalSkin;
+        double pb = totalBack > 0 ? back[i] / totalBack : 0.0;
+        double p = (ps + pb) > 0 ? ps / (ps + pb) : 0.0;
+        prob[i] = saturate_cast<uchar>(p * 255.0);
+    }
+    updateBinary();
+}
+
+void SkinLut::clearSamples() {
+    fill(skinCount.begin(), skinCount.end(), 0.0f);
+    fill(backCount.begin(), backCount.end(), 0.0f);
+}
+
+void SkinLut::setThreshold(int value) {
+    threshold = value;
+    updateBinary();
+}
+
+void SkinLut::updateBinary() {
+    if (prob.empty()) return;
+    binary.resize(SIZE);
+    for (int i = 0; i < SIZE; i++)
+        binary[i] = prob[i] >= threshold ? 255 : 0;
+}
+
+void SkinLut::apply(const Mat& bgr, Mat& mask) const {
+    CV_Assert(bgr.type() == CV_8UC3 && ready());
+
+    mask.create(bgr.size(), CV_8UC1);
+    const uchar* lut = binary.data();
+
+    parallel_for_(Range(0, bgr.rows), [&](const Range& range) {
+        for (int y = range.start; y < range.end; y++) {
+            const uchar* src = bgr.ptr<uchar>(y);
+            uchar* dst = mask.ptr<uchar>(y);
+            for (int x = 0; x < bgr.cols; x++, src += 3)
+                dst[x] = lut[index(src[0], src[1], src[2])];
+        }
+    });
+}
+
+bool SkinLut::save(const string& filename) {
+    FileStorage fs(filename, FileStorage::WRITE);
+    if (!fs.isOpened() || prob.empty()) return false;
+
+    fs << "threshold" << threshold;
+    fs << "prob" << Mat(prob);
+    fs.release();
+
+    // no recargar nuestro propio archivo
+    path = filename;
+    error_code ec;
+    loadedTime = filesystem::last_write_time(filename, ec);
+    return true;
+}
+
+bool SkinLut::load(const string& filename) {
+    FileStorage fs(filename, FileStorage::READ);
+    if (!fs.isOpened()) return false;
+
+    Mat m;
+    fs["prob"] >> m;
+    if (m.type() != CV_8U || m.total() != (size_t)SIZE || !m.isContinuous()) {
+        cerr << "SkinLut: tabla invalida en " << filename << "\n";
+        return false;
+    }
+    if (!fs["threshold"].empty()) fs["threshold"] >> threshold;
+
+    prob.assign(m.ptr<uchar>(), m.ptr<uchar>() + SIZE);
+    updateBinary();
+
+    path = filename;
+    error_code ec;
+    loadedTime = filesystem::last_write_time(filename, ec);
+    cout << "Tabla de piel cargada: " << filename << "\n";
+    return true;
+}
+
+bool SkinLut::reloadIfChanged() {
+    if (path.empty()) return false;
+
+    auto now = chrono::steady_clock::now();
+    if (now - lastCheck < chrono::seconds(1)) return false;
+    lastCheck = now;
+
+    error_code ec;
+    auto t = filesystem::last_write_time(path, ec);
+    if (ec || t == loadedTime) return false;
+    return load(path);
+}
@@ -0,0 +1,61 @@
+// Mide el horneado de la linea de carrera y el costo por tick de los rivales
+// Uso: ai_bench <modelo.obj> [cache.yml.gz]
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "../include/mesh_data.h"
+#include "../include/racing_line.h"
+#include "../include/opponents.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <modelo.obj> [cache.yml.gz]\n";
+        return -1;
+    }
+    std::string cachePath = argc > 2 ? argv[2] : "pista_cache.yml.gz";
+
+    MeshData mesh;
+    if (!LoadMeshData(argv[1], mesh) || mesh.indices.empty()) return -1;
+
+    // misma transformacion pista -> espacio del carro que usa GameController
+    glm::mat4 pista = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f));
+    pista = glm::rotate(pista, glm::radians(-90.0f), glm::vec3(1, 0, 0));
+    pista = glm::translate(pista, glm::vec3(0.3f, -0.2f, -0.2f));
+    glm::mat4 carro = glm::scale(glm::mat4(1.0f), glm::vec3(0.2f));
+    carro = glm::rotate(carro, glm::radians(90.0f), glm::vec3(1, 0, 0));
+    glm::mat4 transform = glm::inverse(carro) * pista;
+
+    // horneado frente a lectura de la cache
+    std::remove(cachePath.c_str());
+    RacingLine line;
+    auto t0 = Clock::now();
+    if (!line.LoadOrBake(cachePath, mesh, transform)) return -1;
+    double bakeMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    RacingLine cached;
+    t0 = Clock::now();
+    cached.LoadOrBake(cachePath, mesh, transform);
+    double loadMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "Horneado + guardado: " << bakeMs << " ms, lectura de cache: " << loadMs << " ms\n";
+
+    // costo por tick a 60 Hz con distintas cantidades de rivales
+    const float dt = 1.0f / 60.0f;
+    const int ticks = 6000;
+    for (int count : { 8, 32, 64, 128 }) {
+        Opponents ai;
+        ai.Reset(line, count);
+        t0 = Clock::now();
+        for (int t = 0; t < ticks; t++) ai.Update(line, dt);
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / ticks;
+
+        int fuera = 0;
+        for (size_t i = 0; i < ai.Size(); i++) fuera += line.Distance(ai.x[i], ai.z[i]) < 0.0f;
+        std::cout << count << " rivales: " << us << " us/tick, " << fuera << " fuera de la pista al final\n";
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// Hornea mallas y texturas (con mipmaps) en un paquete binario mapeable
+// Uso: asset_baker <salida.pack> <modelo.obj>...
+// Ejecutar desde build/ con las mismas rutas que usa el juego, p.ej.
+//   asset_baker ../models/recursos.pack ../models/carro2/Carro.obj "../models/pista/The Circuit.obj"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#define STB_IMAGE_IMPLEMENTATION
+#include "../include/stb_image.h"
+#include "../include/asset_pack.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <salida.pack> <modelo.obj>...\n";
+        return -1;
+    }
+    std::vector<std::string> models(argv + 2, argv + argc);
+
+    auto t0 = Clock::now();
+    if (!WriteAssetPack(argv[1], models)) {
+        std::cerr << "No se pudo escribir " << argv[1] << "\n";
+        return -1;
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    AssetPack pack;
+    if (!pack.Open(argv[1])) {
+        std::cerr << "El paquete escrito no es valido\n";
+        return -1;
+    }
+    std::cout << "Paquete " << argv[1] << ": " << models.size() << " modelos en " << ms << " ms\n";
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Mide el costo de las consultas de colision contra la malla de la pista
+// Uso: bvh_bench <modelo.obj> [rayos]
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../include/mesh_data.h"
+#include "../include/track_bvh.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Ray {
+    glm::vec3 origin, dir;
+    float maxT;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <modelo.obj> [rayos]\n";
+        return -1;
+    }
+    int numRays = argc > 2 ? std::atoi(argv[2]) : 100000;
+
+    MeshData mesh;
+    if (!LoadMeshData(argv[1], mesh) || mesh.indices.empty()) return -1;
+
+    // construccion (promedio de varias repeticiones)
+    TrackBVH bvh;
+    const int buildReps = 5;
+    auto t0 = Clock::now();
+    for (int i = 0; i < buildReps; i++) bvh.Build(mesh);
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / buildReps;
+    std::cout << bvh.TriangleCount() << " triangulos, " << bvh.NodeCount() << " nodos, profundidad "
+              << bvh.Depth() << ", construccion " << buildMs << " ms\n";
+
+    // el modelo esta normalizado a [-1,1]
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Ray> rays(numRays), ground(numRays);
+    for (int i = 0; i < numRays; i++) {
+        glm::vec3 d(unit(rng), unit(rng), unit(rng));
+        if (glm::length(d) < 1e-3f) d = glm::vec3(0, 0, 1);
+        rays[i] = { glm::vec3(unit(rng), unit(rng), unit(rng)) * 1.2f, glm::normalize(d), 0.5f };
+        // consultas de suelo verticales, como las del juego
+        ground[i] = { glm::vec3(unit(rng), 1.5f, unit(rng)), glm::vec3(0, -1, 0), 3.0f };
+    }
+
+    auto bench = [&](const char* name, const std::vector<Ray>& set, bool brute, int count) {
+        TrackHit hit;
+        int hits = 0;
+        auto t0 = Clock::now();
+        for (int i = 0; i < count; i++) {
+            const Ray& r = set[i];
+            bool h = brute ? bvh.RaycastBruteForce(r.origin, r.dir, r.maxT, hit)
+                           : bvh.Raycast(r.origin, r.dir, r.maxT, hit);
+            hits += h;
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / count;
+        std::cout << name << ": " << ns << " ns/consulta, " << hits << "/" << count << " impactos\n";
+    };
+
+    // fuerza bruta con menos rayos: es O(triangulos) por consulta
+    int bruteCount = std::min(numRays, 1000);
+    bench("BVH, rayos cortos", rays, false, numRays);
+    bench("BVH, suelo", ground, false, numRays);
+    bench("Fuerza bruta, rayos cortos", rays, true, bruteCount);
+    bench("Fuerza bruta, suelo", ground, true, bruteCount);
+
+    // verificacion: ambos metodos deben dar el mismo impacto
+    int mismatches = 0;
+    for (int i = 0; i < bruteCount; i++) {
+        TrackHit a, b;
+        bool ha = bvh.Raycast(ground[i].origin, ground[i].dir, ground[i].maxT, a);
+        bool hb = bvh.RaycastBruteForce(ground[i].origin, ground[i].dir, ground[i].maxT, b);
+        if (ha != hb || (ha && std::fabs(a.t - b.t) > 1e-5f)) mismatches++;
+    }
+    std::cout << "Diferencias BVH vs fuerza bruta: " << mismatches << "/" << bruteCount << "\n";
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Entrena el clasificador punio / mano abierta a partir de CSV etiquetados
+// Uso: gesture_train <salida.yml> <muestras.csv> [<muestras.csv> ...]
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include "../include/vision/hand_classifier.h"
+
+using Clock = std::chrono::steady_clock;
+
+static void evaluate(const HandClassifier& clf, const std::vector<HandFeatureVec>& X,
+                     const std::vector<int>& labels,
+                     const std::function<double(const HandFeatureVec&)>& predict) {
+    int confusion[2][2] = { {0, 0}, {0, 0} };   // [real][predicho]
+    for (size_t i = 0; i < X.size(); i++) {
+        int pred = predict(X[i]) >= 0.5 ? 1 : 0;
+        confusion[labels[i]][pred]++;
+    }
+
+    // tiempo de inferencia por muestra
+    const int reps = 2000;
+    volatile double sink = 0;
+    auto t0 = Clock::now();
+    for (int r = 0; r < reps; r++)
+        for (const auto& x : X) sink = sink + predict(x);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (reps * X.size());
+
+    int correct = confusion[0][0] + confusion[1][1];
+    std::cout << "  " << clf.name() << ": exactitud " << 100.0 * correct / X.size() << "%, "
+              << ns << " ns/muestra\n"
+              << "                 pred abierta  pred punio\n"
+              << "    real abierta " << confusion[0][0] << "            " << confusion[0][1] << "\n"
+              << "    real punio   " << confusion[1][0] << "            " << confusion[1][1] << "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <salida.yml> <muestras.csv> [<muestras.csv> ...]\n";
+        return -1;
+    }
+
+    std::vector<HandFeatureVec> X;
+    std::vector<int> labels;
+    for (int i = 2; i < argc; i++) {
+        if (!readFeatureCsv(argv[i], X, labels))
+            std::cerr << "No se pudo leer " << argv[i] << "\n";
+    }
+    if (X.size() < 10) {
+        std::cerr << "Muy pocas muestras (" << X.size() << ")\n";
+        return -1;
+    }
+
+    // 80% entrenamiento / 20% prueba
+    std::vector<size_t> order(X.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    size_t nTrain = order.size() * 4 / 5;
+    std::vector<HandFeatureVec> trainX, testX;
+    std::vector<int> trainY, testY;
+    for (size_t i = 0; i < order.size(); i++) {
+        bool train = i < nTrain;
+        (train ? trainX : testX).push_back(X[order[i]]);
+        (train ? trainY : testY).push_back(labels[order[i]]);
+    }
+
+    LogisticClassifier logistic;
+    logistic.train(trainX, trainY);
+
+    std::cout << trainX.size() << " muestras de entrenamiento, " << testX.size() << " de prueba\n";
+    std::cout << "Conjunto de prueba:\n";
+
+    // los pesos fijos solo usan solidity, defects y aspect
+    WeightedClassifier weighted;
+    evaluate(weighted, testX, testY, [&](const HandFeatureVec& x) {
+        HandFeatures f;
+        f.solidity = x[0]; f.defects = x[1]; f.aspect = x[2];
+        return weighted.fistProbability(f);
+    });
+    evaluate(logistic, testX, testY, [&](const HandFeatureVec& x) {
+        return logistic.probability(x);
+    });
+
+    // modelo final con todas las muestras
+    logistic.train(X, labels);
+    if (!logistic.save(argv[1])) {
+        std::cerr << "No se pudo guardar " << argv[1] << "\n";
+        return -1;
+    }
+    std::cout << "Modelo guardado en " << argv[1] << "\n";
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Mide el costo por frame del pipeline de mano sobre un video grabado
+// Uso: hand_bench <video> [skin_lut.yml]
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/vision/gesture_recognition.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+    std::string name;
+    std::function<void(VisionProcessor&)> setup;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <video> [skin_lut.yml]\n";
+        return -1;
+    }
+
+    cv::VideoCapture cap(argv[1]);
+    std::vector<cv::Mat> frames;
+    cv::Mat frame;
+    while (cap.read(frame)) frames.push_back(frame.clone());
+    if (frames.empty()) {
+        std::cerr << "No se pudieron leer frames de " << argv[1] << "\n";
+        return -1;
+    }
+    std::string lutPath = argc > 2 ? argv[2] : "";
+
+    std::vector<BenchConfig> configs = {
+        { "HSV, resolucion completa", [](VisionProcessor& v) {
+            v.useSkinLut = false; v.workSize = cv::Size(); v.useRoi = false; v.useTracking = false; } },
+        { "HSV, 320x240 + ROI", [](VisionProcessor& v) {
+            v.useSkinLut = false; v.useTracking = false; } },
+        { "Tabla, 320x240 + ROI", [&](VisionProcessor& v) {
+            if (!lutPath.empty()) v.skinLut.load(lutPath);
+            v.useTracking = false; } },
+        { "Tabla, 320x240 + ROI + LK", [&](VisionProcessor& v) {
+            if (!lutPath.empty()) v.skinLut.load(lutPath); } },
+        { "Tabla, 320x240 + fondo", [&](VisionProcessor& v) {
+            if (!lutPath.empty()) v.skinLut.load(lutPath);
+            v.useTracking = false; v.useRoi = false; v.useBackground = true; } },
+        { "Tabla, 320x240 sin fondo", [&](VisionProcessor& v) {
+            if (!lutPath.empty()) v.skinLut.load(lutPath);
+            v.useTracking = false; v.useRoi = false; } },
+        { "Tabla, 320x240, findContours + contourArea", [&](VisionProcessor& v) {
+            if (!lutPath.empty()) v.skinLut.load(lutPath);
+            v.useTracking = false; v.useRoi = false; v.useConnectedComponents = false; } },
+    };
+
+    std::vector<HandFeatures> samples;
+
+    std::cout << frames.size() << " frames de " << frames[0].cols << "x" << frames[0].rows << "\n";
+    for (const auto& config : configs) {
+        VisionProcessor vision;
+        config.setup(vision);
+
+        int detected = 0, tracked = 0;
+        double maskPixels = 0, blobs = 0;
+        auto t0 = Clock::now();
+        for (const auto& f : frames) {
+            vision.processHand(f);
+            vision.update();
+            if (vision.handDetected) detected++;
+            if (vision.lastFrameTracked) tracked++;
+            else { maskPixels += vision.stats.maskPixels; blobs += vision.stats.blobs; }
+            if (samples.size() < frames.size()) samples.push_back(vision.features);
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        std::cout << config.name << ": " << ms / frames.size() << " ms/frame, mano en "
+                  << detected << "/" << frames.size() << " frames, " << tracked << " por seguimiento\n";
+        int segmented = std::max<int>(1, (int)frames.size() - tracked);
+        std::cout << "    " << maskPixels / segmented << " px de piel, "
+                  << blobs / segmented << " blobs por frame segmentado\n";
+    }
+
+    // orientacion por momentos contra fitLine sobre los mismos frames
+    {
+        VisionProcessor byLine, byMoments;
+        byLine.useTracking = byMoments.useTracking = false;
+        byLine.useMomentOrientation = false;
+        if (!lutPath.empty()) { byLine.skinLut.load(lutPath); byMoments.skinLut.load(lutPath); }
+
+        double sumDiff = 0, maxDiff = 0;
+        int compared = 0, gestureChanges = 0;
+        for (const auto& f : frames) {
+            byLine.processHand(f);    byLine.update();
+            byMoments.processHand(f); byMoments.update();
+            if (!byLine.handDetected || !byMoments.handDetected) continue;
+
+            double d = std::fabs(byLine.features.angle - byMoments.features.angle);
+            d = std::min(d, 180.0 - d);
+            sumDiff += d;
+            maxDiff = std::max(maxDiff, d);
+            compared++;
+            if (byLine.gesture != byMoments.gesture) gestureChanges++;
+        }
+        if (compared > 0)
+            std::cout << "Momentos vs fitLine: " << sumDiff / compared << " grados de diferencia media, "
+                      << maxDiff << " maxima, gesto distinto en " << gestureChanges << "/" << compared << " frames\n";
+    }
+
+    // clasificacion sola, sobre los rasgos ya extraidos
+    const int reps = 1000;
+    int stops = 0;
+    auto t0 = Clock::now();
+    for (int r = 0; r < reps; r++)
+        for (const auto& f : samples)
+            if (classifyGesture(f) == Gesture::Stop) stops++;
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    std::cout << "classifyGesture: " << ns / (reps * samples.size()) << " ns/muestra ("
+              << stops / reps << " STOP)\n";
+    return 0;
+}
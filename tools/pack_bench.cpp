@@ -0,0 +1,147 @@
+// Mide la carga de recursos: Assimp + stb (con mipmaps en CPU) frente al paquete horneado
+// Uso: pack_bench <recursos.pack> <modelo.obj>... [--repeticiones N]
+// "frio" expulsa los archivos de la cache de paginas (posix_fadvise) antes de cada
+// repeticion; no equivale a un disco recien montado pero evita medir solo memoria.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#define STB_IMAGE_IMPLEMENTATION
+#include "../include/stb_image.h"
+#include "../include/asset_pack.h"
+#include "../include/mesh_optimizer.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// Expulsa de la cache el archivo (o todos los de un directorio)
+static void evict(const std::filesystem::path& p) {
+#ifndef _WIN32
+    std::error_code ec;
+    if (std::filesystem::is_directory(p, ec)) {
+        for (const auto& e : std::filesystem::directory_iterator(p, ec))
+            if (e.is_regular_file()) evict(e.path());
+        return;
+    }
+    int fd = open(p.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    (void)p;
+#endif
+}
+
+// Lo que hace ModelRenderer sin paquete, sin la parte de OpenGL
+static size_t loadFromSources(const std::vector<std::string>& models) {
+    size_t bytes = 0;
+    std::vector<unsigned char> chain;
+    for (const std::string& model : models) {
+        MeshData mesh;
+        if (!LoadMeshData(model, mesh)) continue;
+        OptimizeMesh(mesh);   // el paquete ya la trae optimizada
+        bytes += mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int);
+
+        std::vector<std::string> seen;
+        for (const MeshMaterial& m : mesh.materials) {
+            if (m.texturePath.empty() || std::find(seen.begin(), seen.end(), m.texturePath) != seen.end()) continue;
+            seen.push_back(m.texturePath);
+            int w, h, c;
+            unsigned char* data = stbi_load(m.texturePath.c_str(), &w, &h, &c, 4);
+            if (!data) continue;
+            BuildMipChain(data, w, h, chain);   // equivalente en CPU de glGenerateMipmap
+            bytes += chain.size();
+            stbi_image_free(data);
+        }
+    }
+    return bytes;
+}
+
+static volatile unsigned int touched = 0;   // evita que se descarte el recorrido
+
+// Lo mismo desde el paquete; se tocan todos los bytes de las texturas (como lo haria la subida)
+static size_t loadFromPack(const std::string& packPath, const std::vector<std::string>& models) {
+    AssetPack pack;
+    if (!pack.Open(packPath)) return 0;
+    size_t bytes = 0;
+    for (const std::string& model : models) {
+        MeshData mesh;
+        if (!pack.LoadMesh(model, mesh)) continue;
+        bytes += mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int);
+
+        std::vector<std::string> seen;
+        for (const MeshMaterial& m : mesh.materials) {
+            if (m.texturePath.empty() || std::find(seen.begin(), seen.end(), m.texturePath) != seen.end()) continue;
+            seen.push_back(m.texturePath);
+            PackedTexture tex;
+            if (!pack.FindTexture(m.texturePath, tex)) continue;
+            size_t n = 0;
+            for (int l = 0; l < tex.levels; l++) n += PackedTexture::LevelBytes(tex.width, tex.height, l);
+            for (size_t i = 0; i < n; i += 4096) touched += tex.data[i];
+            bytes += n;
+        }
+    }
+    return bytes;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <recursos.pack> <modelo.obj>... [--repeticiones N]\n";
+        return -1;
+    }
+    std::string packPath = argv[1];
+    std::vector<std::string> models;
+    int reps = 5;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--repeticiones") == 0 && i + 1 < argc) reps = std::atoi(argv[++i]);
+        else models.push_back(argv[i]);
+    }
+
+    auto evictAll = [&]() {
+        evict(packPath);
+        for (const std::string& m : models) evict(std::filesystem::path(m).parent_path());
+    };
+
+    struct Result { double cold = 0, warm = 0; size_t bytes = 0; };
+    auto run = [&](auto load) {
+        Result r;
+        for (int i = 0; i < reps; i++) {
+            evictAll();
+            auto t0 = Clock::now();
+            r.bytes = load();
+            r.cold += msSince(t0);
+        }
+        load();
+        for (int i = 0; i < reps; i++) {
+            auto t0 = Clock::now();
+            load();
+            r.warm += msSince(t0);
+        }
+        r.cold /= reps;
+        r.warm /= reps;
+        return r;
+    };
+
+    Result src = run([&]() { return loadFromSources(models); });
+    Result pak = run([&]() { return loadFromPack(packPath, models); });
+
+    std::cout << "Paquete: " << std::filesystem::file_size(packPath) / 1024 << " KB, "
+              << pak.bytes / (1024 * 1024) << " MB listos para subir\n";
+    std::cout << "Assimp + stb : frio " << src.cold << " ms, caliente " << src.warm << " ms\n";
+    std::cout << "Paquete      : frio " << pak.cold << " ms, caliente " << pak.warm << " ms\n";
+    std::cout << "Aceleracion  : frio x" << src.cold / std::max(pak.cold, 1e-3)
+              << ", caliente x" << src.warm / std::max(pak.warm, 1e-3) << "\n";
+    return 0;
+}
@@ -0,0 +1,32 @@
+// Entrena la tabla de piel offline a partir de pares imagen / mascara
+// Uso: skin_lut_train <salida.yml> <imagen> <mascara> [<imagen> <mascara> ...]
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include "../include/vision/skin_lut.h"
+
+int main(int argc, char** argv) {
+    if (argc < 4 || (argc - 2) % 2 != 0) {
+        std::cerr << "Uso: " << argv[0] << " <salida.yml> <imagen> <mascara> [<imagen> <mascara> ...]\n";
+        return -1;
+    }
+
+    SkinLut lut;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        cv::Mat img = cv::imread(argv[i], cv::IMREAD_COLOR);
+        cv::Mat mask = cv::imread(argv[i + 1], cv::IMREAD_GRAYSCALE);
+        if (img.empty() || mask.empty() || img.size() != mask.size()) {
+            std::cerr << "No se pudo usar el par " << argv[i] << " / " << argv[i + 1] << "\n";
+            continue;
+        }
+        lut.addSamples(img, mask);
+        std::cout << "Muestras: " << argv[i] << "\n";
+    }
+
+    lut.build();
+    if (!lut.ready() || !lut.save(argv[1])) {
+        std::cerr << "No se pudo generar la tabla\n";
+        return -1;
+    }
+    std::cout << "Tabla guardada en " << argv[1] << "\n";
+    return 0;
+}